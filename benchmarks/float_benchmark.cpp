@@ -0,0 +1,68 @@
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <tiny_parse/floating.hpp>
+#include <tiny_parse/tiny_parse.hpp>
+#include <vector>
+
+namespace {
+
+// Random doubles in the shortest representation that round trips, like in JSON documents.
+std::vector<std::string> make_inputs(size_t count) {
+  std::vector<std::string> inputs;
+  inputs.reserve(count);
+  uint64_t state = 0x9E3779B97F4A7C15;
+  char buffer[64];
+  while (inputs.size() < count) {
+    state ^= state << 13U;
+    state ^= state >> 7U;
+    state ^= state << 17U;
+    const auto value = static_cast<double>(state >> 11U) / static_cast<double>(1ULL << 53U);
+    const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    if (error == std::errc{}) inputs.emplace_back(buffer, end);
+  }
+  return inputs;
+}
+
+template <class F>
+void run(const char* name, const std::vector<std::string>& inputs, F&& parse) {
+  constexpr int rounds = 20;
+  double sum = 0;
+  size_t bytes = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; ++round) {
+    for (const auto& input : inputs) {
+      sum += parse(input);
+      bytes += input.size();
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  const auto numbers = static_cast<double>(inputs.size()) * rounds;
+  std::printf("%-16s %8.1f MB/s %8.1f ns/number (checksum %g)\n", name,
+              static_cast<double>(bytes) / elapsed.count() / 1e6,
+              elapsed.count() * 1e9 / numbers, sum);
+}
+
+}  // namespace
+
+int main() {
+  const auto inputs = make_inputs(100000);
+
+  run("double_", inputs, [](const std::string& input) {
+    double value = 0;
+    (void)tiny_parse::built_in::double_.parse(input, value);
+    return value;
+  });
+  run("std::from_chars", inputs, [](const std::string& input) {
+    double value = 0;
+    std::from_chars(input.data(), input.data() + input.size(), value);
+    return value;
+  });
+  run("std::strtod", inputs, [](const std::string& input) {
+    return std::strtod(input.c_str(), nullptr);
+  });
+}
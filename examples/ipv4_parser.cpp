@@ -1,14 +1,9 @@
-#include <algorithm>
-#include <charconv>
 #include <cstdint>
-#include <functional>
 #include <iostream>
 #include <optional>
-#include <stdexcept>
-#include <string>
 #include <string_view>
-#include <system_error>
 #include <tiny_parse/built_in.hpp>
+#include <tiny_parse/numeric.hpp>
 #include <tiny_parse/tiny_parse.hpp>
 #include <vector>
 
@@ -17,14 +12,7 @@ class Validator {
   Validator() = default;
   ~Validator() = default;
 
-  void validate_byte(std::string_view sv) {
-    uint8_t byte{};
-    auto [ptr, ec]{std::from_chars(sv.data(), sv.data() + sv.size(), byte)};
-    if (ec != std::errc())
-      throw std::invalid_argument{"Value \"" + std::string(sv) + "\" not in range [0, 255]"};
-
-    ip_.push_back(byte);
-  }
+  void add_byte(uint8_t byte) { ip_.push_back(byte); }
 
  private:
   std::vector<uint8_t> ip_;
@@ -37,9 +25,9 @@ int main() {
 
   Validator validator;
 
-  // Define what constitutes a digit
-  auto byte = built_in::whole_number;
-  byte.consumer(std::bind(&Validator::validate_byte, &validator, std::placeholders::_1));
+  // A byte is a number in [0, 255], it is converted while it is parsed
+  const auto byte =
+      built_in::uint_<uint8_t, 0, 255>.action([&](uint8_t b) { validator.add_byte(b); });
 
   auto dot = built_in::CharP<'.'>{};
   auto ip_parser = byte & dot & byte & dot & byte & dot & byte;
@@ -1,5 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
 #include "tiny_parse.hpp"
 
 namespace tiny_parse::built_in {
@@ -7,16 +15,31 @@ namespace tiny_parse::built_in {
 /**
  * @brief A parser that matches a single character.
  *
+ * Like a literal, it doesn't produce a value, so that punctuation doesn't show up in the values of
+ * sequences. Character classes, e.g. RangeP, produce the matched character.
+ *
  * @tparam C The character to match.
  */
 template <char C>
 class CharP : public BaseParser<CharP<C>> {
  public:
-  [[nodiscard]] size_t min_length() const noexcept override { return 1; }
+  static constexpr CharSet first = CharSet::single(C);
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+  static constexpr size_t max_width = 1;
+  static constexpr RequiredLiteral required{{C}, 1, 0, 0};
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+  /** @brief Match the next character without a bounds check, see detail::has_match_at. */
+  [[nodiscard]] static constexpr bool match_at(const char* data) noexcept { return *data == C; }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
+  friend class BaseParser<CharP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
     if (!sv.empty() && sv.front() == C) return {sv.substr(1), true};
+    if (sv.empty()) tiny_parse::detail::mark_end();
     return {sv, false};
   }
 };
@@ -30,13 +53,36 @@ class CharP : public BaseParser<CharP<C>> {
 template <char lower, char upper>
 class RangeP : public BaseParser<RangeP<lower, upper>> {
  public:
-  [[nodiscard]] size_t min_length() const noexcept override { return 1; }
+  using attribute_type = char;
+
+  static constexpr CharSet first = CharSet::range(lower, upper);
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+  static constexpr size_t max_width = 1;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+  /** @brief Match the next character without a bounds check, see detail::has_match_at. */
+  [[nodiscard]] static constexpr bool match_at(const char* data) noexcept {
+    return *data >= lower && *data <= upper;
+  }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
+  friend class BaseParser<RangeP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
     if (!sv.empty() && sv.front() >= lower && sv.front() <= upper) return {sv.substr(1), true};
+    if (sv.empty()) tiny_parse::detail::mark_end();
     return {sv, false};
   }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    const auto result = parse_it(sv);
+    if (result.success) attribute = sv.front();
+    return result;
+  }
 };
 
 /**
@@ -44,47 +90,307 @@ class RangeP : public BaseParser<RangeP<lower, upper>> {
  */
 class AnyP : public BaseParser<AnyP> {
  public:
-  [[nodiscard]] size_t min_length() const noexcept override { return 1; }
+  using attribute_type = char;
+
+  static constexpr CharSet first = CharSet::all();
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+  static constexpr size_t max_width = 1;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+  /** @brief Match the next character without a bounds check, see detail::has_match_at. */
+  [[nodiscard]] static constexpr bool match_at(const char* /*data*/) noexcept { return true; }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
+  friend class BaseParser<AnyP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
     if (!sv.empty()) return {sv.substr(1), true};
+    tiny_parse::detail::mark_end();
     return {sv, false};
   }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    const auto result = parse_it(sv);
+    if (result.success) attribute = sv.front();
+    return result;
+  }
 };
 
-const auto digit = RangeP<'0', '9'>{};
+/**
+ * @brief A parser that matches a literal string.
+ *
+ * The input is checked with a single bounds check and a word-wise comparison. Sequences of CharP
+ * and LitP parsers are merged into a single LitP, e.g. `CharP<'G'>{} & CharP<'E'>{}` is a
+ * `LitP<'G', 'E'>`. With C++20, `Lit<"GET">` can be used instead of spelling out the characters.
+ *
+ * @tparam Cs The characters of the literal.
+ */
+template <char... Cs>
+class LitP : public BaseParser<LitP<Cs...>> {
+  static_assert(sizeof...(Cs) > 0, "A literal needs at least one character");
+
+ public:
+  static constexpr CharSet first = CharSet::single(std::array<char, sizeof...(Cs)>{Cs...}[0]);
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = sizeof...(Cs);
+  static constexpr size_t max_width = sizeof...(Cs);
+  static constexpr RequiredLiteral required = [] {
+    constexpr std::array<char, sizeof...(Cs)> chars{Cs...};
+    RequiredLiteral literal{{}, std::min(chars.size(), RequiredLiteral::max_size), 0, 0};
+    for (size_t i = 0; i < literal.size; ++i) literal.chars[i] = chars[i];
+    return literal;
+  }();
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return sizeof...(Cs); }
+
+  /** @brief Match the next characters without a bounds check, see detail::has_match_at. */
+  [[nodiscard]] static constexpr bool match_at(const char* data) noexcept {
+    return tiny_parse::detail::starts_with<Cs...>(data);
+  }
+
+ protected:
+  friend class BaseParser<LitP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    if (sv.size() >= sizeof...(Cs) && tiny_parse::detail::starts_with<Cs...>(sv.data())) {
+      return {sv.substr(sizeof...(Cs)), true};
+    }
+    if (sv.size() < sizeof...(Cs) && is_prefix(sv)) tiny_parse::detail::mark_end();
+    return {sv, false};
+  }
+
+ private:
+  /** @brief Whether the input is a prefix of the literal, so that more input could match it. */
+  static constexpr bool is_prefix(const std::string_view& sv) noexcept {
+    constexpr std::array<char, sizeof...(Cs)> chars{Cs...};
+    for (size_t i = 0; i < sv.size(); ++i) {
+      if (sv[i] != chars[i]) return false;
+    }
+    return true;
+  }
+};
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+/**
+ * @brief A string literal usable as a template argument.
+ *
+ * @tparam N The size of the string, including the terminating null character.
+ */
+template <size_t N>
+struct FixedString {
+  // NOLINTNEXTLINE(google-explicit-constructor): Implicit, to allow Lit<"...">.
+  constexpr FixedString(const char (&str)[N]) noexcept {
+    for (size_t i = 0; i < N; ++i) chars[i] = str[i];
+  }
+
+  char chars[N]{};
+};
+
+namespace detail {
+
+template <FixedString S, size_t... Is>
+LitP<S.chars[Is]...> make_lit(std::index_sequence<Is...> /*unused*/);
+
+}  // namespace detail
+
+/** @brief The LitP parser matching the given string. */
+template <FixedString S>
+using Lit = decltype(detail::make_lit<S>(std::make_index_sequence<sizeof(S.chars) - 1>{}));
+#endif
+
+/**
+ * @brief A parser that matches any character of a set.
+ *
+ * The set is stored as a 256-bit mask, so matching a character is a single table lookup.
+ * Character classes are usually not spelled out, but created by combining other single character
+ * parsers:
+ * - `a | b` matches any character matched by `a` or `b`,
+ * - `a - b` matches any character matched by `a` but not by `b`,
+ * - `-a` matches any character not matched by `a`.
+ *
+ * @tparam W0 Bits 0 to 63 of the mask.
+ * @tparam W1 Bits 64 to 127 of the mask.
+ * @tparam W2 Bits 128 to 191 of the mask.
+ * @tparam W3 Bits 192 to 255 of the mask.
+ */
+template <uint64_t W0, uint64_t W1, uint64_t W2, uint64_t W3>
+class CharClass : public BaseParser<CharClass<W0, W1, W2, W3>> {
+ public:
+  using attribute_type = char;
+
+  static constexpr CharSet first = CharSet::from_words(W0, W1, W2, W3);
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+  static constexpr size_t max_width = 1;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+  /** @brief Match the next character without a bounds check, see detail::has_match_at. */
+  [[nodiscard]] static constexpr bool match_at(const char* data) noexcept {
+    return first.contains(*data);
+  }
+
+ protected:
+  friend class BaseParser<CharClass>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    if (!sv.empty() && first.contains(sv.front())) return {sv.substr(1), true};
+    if (sv.empty()) tiny_parse::detail::mark_end();
+    return {sv, false};
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    const auto result = parse_it(sv);
+    if (result.success) attribute = sv.front();
+    return result;
+  }
+};
+
+/** @brief The CharClass parser matching the given set. */
+template <const CharSet& Set>
+using CharClassOf = CharClass<Set.word(0), Set.word(1), Set.word(2), Set.word(3)>;
+
+}  // namespace tiny_parse::built_in
+
+namespace tiny_parse {
+
+template <char C>
+struct is_char_class<built_in::CharP<C>> : std::true_type {};
+
+template <char lower, char upper>
+struct is_char_class<built_in::RangeP<lower, upper>> : std::true_type {};
+
+template <>
+struct is_char_class<built_in::AnyP> : std::true_type {};
+
+template <uint64_t W0, uint64_t W1, uint64_t W2, uint64_t W3>
+struct is_char_class<built_in::CharClass<W0, W1, W2, W3>> : std::true_type {};
+
+namespace built_in::detail {
+
+template <class T>
+struct literal_of {};
+
+template <char C>
+struct literal_of<CharP<C>> {
+  using type = LitP<C>;
+};
+
+template <char... Cs>
+struct literal_of<LitP<Cs...>> {
+  using type = LitP<Cs...>;
+};
+
+template <class T, class S>
+struct concat_literals {};
+
+template <char... Cs, char... Ds>
+struct concat_literals<LitP<Cs...>, LitP<Ds...>> {
+  using type = LitP<Cs..., Ds...>;
+};
+
+}  // namespace built_in::detail
+
+template <class T, class S>
+struct sequence_merge<T, S,
+                      std::void_t<typename built_in::detail::literal_of<T>::type,
+                                  typename built_in::detail::literal_of<S>::type>>
+    : std::true_type {
+  static constexpr auto merge(const T& /*unused*/, const S& /*unused*/) noexcept {
+    return typename built_in::detail::concat_literals<
+        typename built_in::detail::literal_of<T>::type,
+        typename built_in::detail::literal_of<S>::type>::type{};
+  }
+};
+
+}  // namespace tiny_parse
+
+namespace tiny_parse::built_in {
+
+namespace detail {
+
+template <class T>
+using enable_if_char_class_t = std::enable_if_t<is_char_class_v<T>>;
+
+template <class T, class S>
+using enable_if_char_classes_t = std::enable_if_t<is_char_class_v<T> && is_char_class_v<S>>;
+
+template <class T, class S>
+struct UnionOf {
+  static constexpr CharSet value = T::first | S::first;
+};
+
+template <class T, class S>
+struct DifferenceOf {
+  static constexpr CharSet value = T::first & ~S::first;
+};
+
+template <class T>
+struct ComplementOf {
+  static constexpr CharSet value = ~T::first;
+};
+
+}  // namespace detail
+
+/** @relates CharClass @brief Creates a CharClass matching the characters of either parser. */
+template <class T, class S, class = detail::enable_if_char_classes_t<T, S>>
+constexpr CharClassOf<detail::UnionOf<T, S>::value> operator|(const T& /*unused*/,
+                                                               const S& /*unused*/) noexcept {
+  return {};
+}
+
+/** @relates CharClass @brief Creates a CharClass matching the characters of the first, but not
+ * the second parser. */
+template <class T, class S, class = detail::enable_if_char_classes_t<T, S>>
+constexpr CharClassOf<detail::DifferenceOf<T, S>::value> operator-(const T& /*unused*/,
+                                                                    const S& /*unused*/) noexcept {
+  return {};
+}
+
+/** @relates CharClass @brief Creates a CharClass matching all characters the parser doesn't. */
+template <class T, class = detail::enable_if_char_class_t<T>>
+constexpr CharClassOf<detail::ComplementOf<T>::value> operator-(const T& /*unused*/) noexcept {
+  return {};
+}
+
+inline constexpr auto digit = RangeP<'0', '9'>{};
 
-const auto whole_number = +digit;
+inline constexpr auto whole_number = +digit;
 
-const auto integer = ~CharP<'-'>{} & whole_number;
+inline constexpr auto integer = ~CharP<'-'>{} & whole_number;
 
-const auto decimal = integer & CharP<'.'>{} & whole_number;
+inline constexpr auto decimal = integer & CharP<'.'>{} & whole_number;
 
-const auto number = integer | decimal;
+inline constexpr auto number = integer & ~(CharP<'.'>{} & whole_number);
 
-const auto lower_case_character = RangeP<'a', 'z'>{};
+inline constexpr auto lower_case_character = RangeP<'a', 'z'>{};
 
-const auto upper_case_character = RangeP<'A', 'Z'>{};
+inline constexpr auto upper_case_character = RangeP<'A', 'Z'>{};
 
-const auto letter = lower_case_character | upper_case_character;
+inline constexpr auto letter = lower_case_character | upper_case_character;
 
-const auto alphanumeric = letter | digit;
+inline constexpr auto alphanumeric = letter | digit;
 
-const auto dash = CharP<'-'>{};
+inline constexpr auto dash = CharP<'-'>{};
 
-const auto dot = CharP<'.'>{};
+inline constexpr auto dot = CharP<'.'>{};
 
-const auto underscore = CharP<'_'>{};
+inline constexpr auto underscore = CharP<'_'>{};
 
-const auto space = CharP<' '>{};
+inline constexpr auto space = CharP<' '>{};
 
-const auto tab = CharP<'\t'>{};
+inline constexpr auto tab = CharP<'\t'>{};
 
-const auto newline = CharP<'\n'>{};
+inline constexpr auto newline = CharP<'\n'>{};
 
-const auto carriage_return = CharP<'\r'>{};
+inline constexpr auto carriage_return = CharP<'\r'>{};
 
-const auto whitespace = space | tab | newline | carriage_return;
+inline constexpr auto whitespace = space | tab | newline | carriage_return;
 
 }  // namespace tiny_parse::built_in
@@ -0,0 +1,555 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include "numeric.hpp"
+#include "powers_of_five.hpp"
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+/** @brief The syntax accepted by a floating-point parser, see built_in::FloatP. */
+enum class FloatFormat {
+  /**
+   * @brief The syntax of std::strtod without hexadecimal floats: an optional sign, digits with an
+   * optional decimal point, an optional exponent, or "inf", "infinity" and "nan" in any case.
+   */
+  general,
+  /**
+   * @brief The number syntax of JSON: an optional minus sign, an integer part without leading
+   * zeros, optional fraction digits after a decimal point and an optional exponent.
+   */
+  json,
+};
+
+}  // namespace tiny_parse
+
+namespace tiny_parse::detail {
+
+/** @brief A 128-bit unsigned integer, as its high and low half. */
+struct UInt128 {
+  uint64_t high;
+  uint64_t low;
+};
+
+/** @brief The full 128-bit product of two 64-bit integers. */
+inline UInt128 multiply_full(uint64_t lhs, uint64_t rhs) noexcept {
+#if defined(__SIZEOF_INT128__)
+  __extension__ using uint128_t = unsigned __int128;
+  const auto product = static_cast<uint128_t>(lhs) * rhs;
+  return {static_cast<uint64_t>(product >> 64U), static_cast<uint64_t>(product)};
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+  uint64_t high{};
+  const auto low = _umul128(lhs, rhs, &high);
+  return {high, low};
+#else
+  const auto lo_lo = (lhs & 0xFFFFFFFFU) * (rhs & 0xFFFFFFFFU);
+  const auto hi_lo = (lhs >> 32U) * (rhs & 0xFFFFFFFFU);
+  const auto lo_hi = (lhs & 0xFFFFFFFFU) * (rhs >> 32U);
+  const auto hi_hi = (lhs >> 32U) * (rhs >> 32U);
+  const auto cross = (lo_lo >> 32U) + (hi_lo & 0xFFFFFFFFU) + lo_hi;
+  return {hi_hi + (hi_lo >> 32U) + (cross >> 32U), (cross << 32U) | (lo_lo & 0xFFFFFFFFU)};
+#endif
+}
+
+/** @brief The IEEE 754 format of a floating-point type. */
+template <class T>
+struct FloatTraits;
+
+template <>
+struct FloatTraits<double> {
+  using Bits = uint64_t;
+  static constexpr int mantissa_bits = 52;
+  static constexpr int minimum_exponent = -1023;
+  static constexpr int infinite_power = 0x7FF;
+  /** @brief Decimal exponents below this always round to zero. */
+  static constexpr int64_t smallest_power_of_ten = -342;
+  /** @brief Decimal exponents above this always overflow. */
+  static constexpr int64_t largest_power_of_ten = 308;
+  /** @brief The range of exponents in which a product can lie exactly halfway between floats. */
+  static constexpr int64_t min_exponent_round_to_even = -4;
+  static constexpr int64_t max_exponent_round_to_even = 23;
+  /** @brief The largest power of ten, and mantissa, that are exact in the type. */
+  static constexpr int64_t max_exponent_fast_path = 22;
+  static constexpr uint64_t max_mantissa_fast_path = uint64_t{2} << mantissa_bits;
+  static constexpr std::array<double, 23> powers_of_ten{
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+};
+
+template <>
+struct FloatTraits<float> {
+  using Bits = uint32_t;
+  static constexpr int mantissa_bits = 23;
+  static constexpr int minimum_exponent = -127;
+  static constexpr int infinite_power = 0xFF;
+  static constexpr int64_t smallest_power_of_ten = -64;
+  static constexpr int64_t largest_power_of_ten = 38;
+  static constexpr int64_t min_exponent_round_to_even = -17;
+  static constexpr int64_t max_exponent_round_to_even = 10;
+  static constexpr int64_t max_exponent_fast_path = 10;
+  static constexpr uint64_t max_mantissa_fast_path = uint64_t{2} << mantissa_bits;
+  static constexpr std::array<float, 11> powers_of_ten{1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                                       1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+};
+
+/** @brief A binary floating-point number, as its biased exponent and its mantissa bits. */
+struct BinaryFloat {
+  uint64_t mantissa{};
+  int32_t power2{};
+
+  constexpr bool operator==(const BinaryFloat& other) const noexcept {
+    return mantissa == other.mantissa && power2 == other.power2;
+  }
+  constexpr bool operator!=(const BinaryFloat& other) const noexcept { return !(*this == other); }
+};
+
+/**
+ * @brief The floating-point number closest to w * 10^q, with the Eisel-Lemire algorithm.
+ *
+ * Multiplies w with a 128-bit approximation of 5^q, see powers_of_five, and rounds the product to
+ * the precision of T. The approximation is always close enough to round correctly, see Mushtak and
+ * Lemire, "Fast number parsing without fallback", 2023. An overflow returns the infinite power.
+ */
+template <class T>
+BinaryFloat compute_float(int64_t q, uint64_t w) noexcept {
+  using Traits = FloatTraits<T>;
+  constexpr int mantissa_bits = Traits::mantissa_bits;
+
+  if (w == 0 || q < Traits::smallest_power_of_ten) return {0, 0};
+  if (q > Traits::largest_power_of_ten) return {0, Traits::infinite_power};
+
+  const auto leading_zeros = static_cast<int>(count_leading_zeros(w));
+  w <<= static_cast<unsigned>(leading_zeros);
+
+  // Only the top mantissa_bits + 3 bits of the product are needed. If they may be affected by the
+  // truncation of 5^q, the product is refined with the next 64 bits of 5^q.
+  const auto index = static_cast<size_t>(2 * (q - smallest_power_of_five));
+  constexpr uint64_t precision_mask = std::numeric_limits<uint64_t>::max() >> (mantissa_bits + 3);
+  auto product = multiply_full(w, powers_of_five[index]);
+  if ((product.high & precision_mask) == precision_mask) {
+    const auto second = multiply_full(w, powers_of_five[index + 1]);
+    product.low += second.high;
+    if (second.high > product.low) ++product.high;
+  }
+
+  const auto upper_bit = static_cast<int>(product.high >> 63U);
+  const auto shift = static_cast<unsigned>(upper_bit + 64 - mantissa_bits - 3);
+  BinaryFloat answer;
+  answer.mantissa = product.high >> shift;
+  // floor(log2(10^q)) = floor(q * log2(10)), approximated as (217706 * q) >> 16.
+  const auto power2 = static_cast<int32_t>(((217706 * q) >> 16) + 63);
+  answer.power2 = power2 + upper_bit - leading_zeros - Traits::minimum_exponent;
+
+  if (answer.power2 <= 0) {
+    // A subnormal number, or zero.
+    if (-answer.power2 + 1 >= 64) return {0, 0};
+    answer.mantissa >>= static_cast<unsigned>(-answer.power2 + 1);
+    answer.mantissa += answer.mantissa & 1U;
+    answer.mantissa >>= 1U;
+    answer.power2 = answer.mantissa < (uint64_t{1} << mantissa_bits) ? 0 : 1;
+    return answer;
+  }
+
+  // A product exactly halfway between two floats rounds to even.
+  if (product.low <= 1 && q >= Traits::min_exponent_round_to_even &&
+      q <= Traits::max_exponent_round_to_even && (answer.mantissa & 3U) == 1 &&
+      (answer.mantissa << shift) == product.high) {
+    answer.mantissa &= ~uint64_t{1};
+  }
+
+  answer.mantissa += answer.mantissa & 1U;
+  answer.mantissa >>= 1U;
+  if (answer.mantissa >= (uint64_t{2} << mantissa_bits)) {
+    answer.mantissa = uint64_t{1} << mantissa_bits;
+    ++answer.power2;
+  }
+  answer.mantissa &= ~(uint64_t{1} << mantissa_bits);
+  if (answer.power2 >= Traits::infinite_power) return {0, Traits::infinite_power};
+  return answer;
+}
+
+/** @brief A decimal number as scanned from the input, see scan_decimal. */
+struct DecimalNumber {
+  enum class Kind { finite, infinity, nan };
+
+  /** @brief The first 19 significant digits. */
+  uint64_t mantissa{};
+  /** @brief The decimal exponent of the last digit in the mantissa. */
+  int64_t exponent{};
+  /** @brief The number of characters of the number, 0 if there is none. */
+  size_t length{};
+  Kind kind{Kind::finite};
+  bool negative{};
+  /** @brief Whether there are more than 19 significant digits, so the mantissa is cut short. */
+  bool truncated{};
+  /** @brief Whether the scan looked at the end of the input. */
+  bool reached_end{};
+};
+
+/** @brief Accumulate the decimal digits starting at i into the mantissa, 8 at a time. */
+inline void accumulate_digits(const std::string_view& sv, size_t& i, uint64_t& mantissa) noexcept {
+  const auto size = sv.size();
+  if (TINY_PARSE_LITTLE_ENDIAN) {
+    while (size - i >= 8) {
+      const auto word = load_word(sv.data() + i);
+      if (non_digit_mask(word) != 0) break;
+      mantissa = mantissa * 100000000 + parse_eight_digits(word);
+      i += 8;
+    }
+  }
+  for (; i < size && is_digit(sv[i]); ++i) {
+    mantissa = mantissa * 10 + static_cast<uint64_t>(sv[i] - '0');
+  }
+}
+
+/** @brief Whether the input starts with the lower case word, ignoring case. */
+inline bool starts_with_word(const std::string_view& sv, const std::string_view& word) noexcept {
+  if (sv.size() < word.size()) return false;
+  for (size_t i = 0; i < word.size(); ++i) {
+    if ((sv[i] | 0x20) != word[i]) return false;
+  }
+  return true;
+}
+
+/** @brief Whether the input is a proper prefix of the lower case word, ignoring case. */
+inline bool is_word_prefix(const std::string_view& sv, const std::string_view& word) noexcept {
+  return sv.size() < word.size() && starts_with_word(sv, word.substr(0, sv.size()));
+}
+
+/**
+ * @brief Scan "inf", "infinity" or "nan" after the sign at i.
+ *
+ * @return DecimalNumber The number, with a length of 0 if there is none.
+ */
+inline DecimalNumber scan_special(const std::string_view& sv, size_t i) noexcept {
+  using namespace std::literals;
+
+  DecimalNumber number;
+  const auto rest = sv.substr(i);
+  if (starts_with_word(rest, "nan"sv)) {
+    number.kind = DecimalNumber::Kind::nan;
+    number.length = i + 3;
+  } else if (starts_with_word(rest, "infinity"sv)) {
+    number.kind = DecimalNumber::Kind::infinity;
+    number.length = i + 8;
+  } else if (starts_with_word(rest, "inf"sv)) {
+    number.kind = DecimalNumber::Kind::infinity;
+    number.length = i + 3;
+    number.reached_end = is_word_prefix(rest, "infinity"sv);
+  } else {
+    number.reached_end = is_word_prefix(rest, "nan"sv) || is_word_prefix(rest, "infinity"sv);
+  }
+  return number;
+}
+
+/**
+ * @brief The first 19 significant digits of a longer mantissa, and the exponent of the last one.
+ *
+ * @param integer The digits before the decimal point.
+ * @param fraction The digits after the decimal point.
+ * @param exponent The explicit exponent of the number.
+ */
+inline std::pair<uint64_t, int64_t> truncate_mantissa(const std::string_view& integer,
+                                                      const std::string_view& fraction,
+                                                      int64_t exponent) noexcept {
+  // Zeros before the first significant digit keep the mantissa at 0.
+  constexpr uint64_t min_nineteen_digits = 1000000000000000000;
+  uint64_t mantissa = 0;
+  size_t i = 0;
+  for (; i < integer.size() && mantissa < min_nineteen_digits; ++i) {
+    mantissa = mantissa * 10 + static_cast<uint64_t>(integer[i] - '0');
+  }
+  if (mantissa >= min_nineteen_digits) {
+    return {mantissa, exponent + static_cast<int64_t>(integer.size() - i)};
+  }
+  for (i = 0; i < fraction.size() && mantissa < min_nineteen_digits; ++i) {
+    mantissa = mantissa * 10 + static_cast<uint64_t>(fraction[i] - '0');
+  }
+  return {mantissa, exponent - static_cast<int64_t>(i)};
+}
+
+/** @brief The number of digits without the leading zeros. */
+inline size_t count_significant_digits(const std::string_view& integer,
+                                       const std::string_view& fraction) noexcept {
+  auto count = integer.size() + fraction.size();
+  size_t i = 0;
+  for (; i < integer.size() && integer[i] == '0'; ++i) --count;
+  if (i < integer.size()) return count;
+  for (i = 0; i < fraction.size() && fraction[i] == '0'; ++i) --count;
+  return count;
+}
+
+/**
+ * @brief Scan a decimal floating-point number at the start of the input.
+ *
+ * The digits are accumulated into the mantissa as they are scanned, 8 at a time. Only numbers with
+ * more than 19 significant digits are looked at a second time, to cut the mantissa short.
+ */
+template <FloatFormat Format>
+DecimalNumber scan_decimal(const std::string_view& sv) noexcept {
+  constexpr bool json = Format == FloatFormat::json;
+
+  const auto size = sv.size();
+  size_t i = 0;
+  bool negative = false;
+  if (i < size && (sv[i] == '-' || (!json && sv[i] == '+'))) {
+    negative = sv[i] == '-';
+    ++i;
+  }
+
+  // The mantissa and the end of input are kept in locals, so that they stay in registers.
+  uint64_t mantissa = 0;
+  bool reached_end = false;
+  const auto int_start = i;
+  accumulate_digits(sv, i, mantissa);
+  auto int_end = i;
+  if constexpr (json) {
+    // The integer part is a single 0 or has no leading zeros, the rest isn't part of the number.
+    if (int_end - int_start > 1 && sv[int_start] == '0') {
+      int_end = i = int_start + 1;
+      mantissa = 0;
+    }
+  } else {
+    if (int_end == int_start) {
+      auto special = scan_special(sv, i);
+      if (special.length != 0) {
+        special.negative = negative;
+        return special;
+      }
+      reached_end = special.reached_end;
+    }
+  }
+
+  auto frac_start = i;
+  auto frac_end = i;
+  if (i < size && sv[i] == '.') {
+    auto j = i + 1;
+    accumulate_digits(sv, j, mantissa);
+    reached_end = reached_end || j == size;
+    // JSON needs digits on both sides of the point, otherwise digits on either side are enough.
+    const bool int_digits = int_end > int_start;
+    const bool frac_digits = j > i + 1;
+    if (json ? int_digits && frac_digits : int_digits || frac_digits) {
+      frac_start = i + 1;
+      frac_end = i = j;
+    }
+  }
+
+  DecimalNumber number;
+  number.negative = negative;
+  if (int_end == int_start && frac_end == frac_start) {
+    number.reached_end = reached_end || i == size;
+    return number;
+  }
+
+  int64_t exponent = 0;
+  if (i < size && (sv[i] == 'e' || sv[i] == 'E')) {
+    auto j = i + 1;
+    const bool negative_exponent = j < size && sv[j] == '-';
+    if (j < size && (sv[j] == '-' || sv[j] == '+')) ++j;
+    const auto exponent_start = j;
+    for (; j < size && is_digit(sv[j]); ++j) {
+      // Larger exponents overflow or underflow anyway, unless the number has hundreds of millions
+      // of digits to make up for them.
+      if (exponent < 0x10000000) exponent = exponent * 10 + (sv[j] - '0');
+    }
+    // Without digits, the exponent isn't part of the number.
+    if (j > exponent_start) {
+      i = j;
+      if (negative_exponent) exponent = -exponent;
+    } else {
+      exponent = 0;
+      reached_end = reached_end || j == size;
+    }
+  }
+  number.length = i;
+  number.reached_end = reached_end || i == size;
+  number.mantissa = mantissa;
+  number.exponent = exponent - static_cast<int64_t>(frac_end - frac_start);
+
+  if ((int_end - int_start) + (frac_end - frac_start) > 19) {
+    const auto integer = sv.substr(int_start, int_end - int_start);
+    const auto fraction = sv.substr(frac_start, frac_end - frac_start);
+    if (count_significant_digits(integer, fraction) > 19) {
+      number.truncated = true;
+      std::tie(number.mantissa, number.exponent) = truncate_mantissa(integer, fraction, exponent);
+    }
+  }
+  return number;
+}
+
+/**
+ * @brief Convert the text of a number with strtof or strtod, for libraries without from_chars.
+ *
+ * Floats are converted with strtof, rounding the double from strtod to a float would round twice.
+ */
+template <class T>
+bool convert_with_strtod(const std::string_view& text, T& value) {
+  // strtod needs a terminated string, and depends on the decimal point of the C locale.
+  const std::string terminated{text};
+  char* end = nullptr;
+  if constexpr (std::is_same_v<T, float>) {
+    value = std::strtof(terminated.c_str(), &end);
+  } else {
+    value = std::strtod(terminated.c_str(), &end);
+  }
+  return end == terminated.c_str() + terminated.size() &&
+         value != std::numeric_limits<T>::infinity();
+}
+
+/**
+ * @brief Convert the text of a number with the standard library.
+ *
+ * Only used for the rare numbers with more than 19 significant digits that lie too close to the
+ * midpoint between two floats to be rounded from their first 19 digits.
+ */
+template <class T>
+bool convert_with_library(const std::string_view& text, T& value) {
+#if defined(__cpp_lib_to_chars)
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc{} && end == text.data() + text.size();
+#else
+  return convert_with_strtod(text, value);
+#endif
+}
+
+/**
+ * @brief The value of a scanned decimal number.
+ *
+ * Small numbers that are exact in T are converted with a single multiplication or division, as
+ * described by Clinger. All others go through compute_float.
+ *
+ * @return false if the number is too large for T.
+ */
+template <class T>
+bool to_float(const std::string_view& sv, const DecimalNumber& number, T& value) {
+  using Traits = FloatTraits<T>;
+  using Bits = typename Traits::Bits;
+
+  if (number.kind != DecimalNumber::Kind::finite) {
+    value = number.kind == DecimalNumber::Kind::nan ? std::numeric_limits<T>::quiet_NaN()
+                                                    : std::numeric_limits<T>::infinity();
+    if (number.negative) value = -value;
+    return true;
+  }
+
+  const auto q = number.exponent;
+  const auto w = number.mantissa;
+  if (!number.truncated && -Traits::max_exponent_fast_path <= q &&
+      q <= Traits::max_exponent_fast_path && w <= Traits::max_mantissa_fast_path) {
+    value = static_cast<T>(w);
+    if (q < 0) {
+      value = value / Traits::powers_of_ten[static_cast<size_t>(-q)];
+    } else {
+      value = value * Traits::powers_of_ten[static_cast<size_t>(q)];
+    }
+    if (number.negative) value = -value;
+    return true;
+  }
+
+  auto binary = compute_float<T>(q, w);
+  // A truncated mantissa is only good enough if rounding it up doesn't change the result.
+  if (number.truncated && binary != compute_float<T>(q, w + 1)) {
+    const size_t sign = sv.front() == '-' || sv.front() == '+' ? 1 : 0;
+    if (convert_with_library({sv.data() + sign, number.length - sign}, value)) {
+      if (number.negative) value = -value;
+      return true;
+    }
+    // The library rejects the tiniest subnormals as out of range, keep the rounded value then.
+  }
+  if (binary.power2 == Traits::infinite_power) return false;
+
+  auto bits = static_cast<Bits>(binary.mantissa) |
+              (static_cast<Bits>(binary.power2) << static_cast<unsigned>(Traits::mantissa_bits));
+  if (number.negative) bits |= Bits{1} << (8 * sizeof(Bits) - 1);
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+}  // namespace tiny_parse::detail
+
+namespace tiny_parse::built_in {
+
+/**
+ * @brief A parser for a floating-point number that produces its value.
+ *
+ * The number is scanned and converted in the same pass: digits are accumulated 8 at a time while
+ * they are validated, and the result is rounded correctly with the Eisel-Lemire algorithm, see
+ * detail::compute_float. Only numbers with more than 19 significant digits that are too close to
+ * call fall back to the standard library.
+ *
+ * Numbers too large for T fail to parse, numbers too small round to zero. An exponent marker that
+ * isn't followed by digits isn't part of the number, e.g. "1e" parses "1".
+ *
+ * @tparam T The floating-point type of the value, float or double.
+ * @tparam Format The accepted syntax, see FloatFormat.
+ */
+template <class T, FloatFormat Format = FloatFormat::general>
+class FloatP : public BaseParser<FloatP<T, Format>> {
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                "FloatP needs float or double");
+  static_assert(std::numeric_limits<T>::is_iec559, "FloatP needs IEEE 754 floating-point types");
+
+ public:
+  using attribute_type = T;
+
+  static constexpr CharSet first =
+      Format == FloatFormat::json
+          ? tiny_parse::detail::decimal_digits | CharSet::single('-')
+          : tiny_parse::detail::decimal_digits | CharSet::single('-') | CharSet::single('+') |
+                CharSet::single('.') | CharSet::single('i') | CharSet::single('I') |
+                CharSet::single('n') | CharSet::single('N');
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+ protected:
+  friend class BaseParser<FloatP>;
+
+  [[nodiscard]] Result parse_it(const std::string_view& sv) const {
+    T value{};
+    return parse_it(sv, value);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] Result parse_it(const std::string_view& sv, Attribute& attribute) const {
+    const auto number = tiny_parse::detail::scan_decimal<Format>(sv);
+    if (number.reached_end) tiny_parse::detail::mark_end();
+    if (number.length == 0) return {sv, false};
+
+    T value{};
+    if (!tiny_parse::detail::to_float(sv, number, value)) return {sv, false};
+
+    attribute = value;
+    return {sv.substr(number.length), true};
+  }
+};
+
+/** @brief A double in the syntax of std::strtod, see FloatP. */
+inline constexpr FloatP<double> double_{};
+
+/** @brief A float in the syntax of std::strtod, see FloatP. */
+inline constexpr FloatP<float> float_{};
+
+/** @brief A JSON number, as a double, see FloatP. */
+inline constexpr FloatP<double, FloatFormat::json> json_number{};
+
+}  // namespace tiny_parse::built_in
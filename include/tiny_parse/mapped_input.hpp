@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+/**
+ * @brief A file mapped read-only into memory, to be parsed without copying it.
+ *
+ * The views handed out, and the results and captured views of parses of them, point into the
+ * mapping and stay valid for as long as it is alive, also when the MappedInput is moved. The file
+ * must not be truncated while it is mapped.
+ */
+class MappedInput {
+ public:
+  /** @brief Hints on how the mapping will be accessed. */
+  struct Options {
+    /** @brief The file is read from front to back, so the kernel can read ahead aggressively. */
+    bool sequential = true;
+    /** @brief The whole file will be needed, so the kernel can start reading it right away. */
+    bool will_need = true;
+    /** @brief Back the mapping with huge pages if the system supports it for files. */
+    bool huge_pages = false;
+  };
+
+  /**
+   * @brief Map the file at the given path.
+   *
+   * @throws std::system_error if the file can't be opened or mapped.
+   */
+  explicit MappedInput(const std::string& path) : MappedInput(path, Options{}) {}
+
+  /**
+   * @brief Map the file at the given path, with hints on how it will be accessed.
+   *
+   * @throws std::system_error if the file can't be opened or mapped.
+   */
+  MappedInput(const std::string& path, const Options& options) { map(path, options); }
+
+  MappedInput(MappedInput&& other) noexcept
+      : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} {}
+
+  MappedInput& operator=(MappedInput&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  MappedInput(const MappedInput&) = delete;
+  MappedInput& operator=(const MappedInput&) = delete;
+
+  ~MappedInput() { unmap(); }
+
+  /** @brief The contents of the file. */
+  [[nodiscard]] std::string_view view() const noexcept { return {data_, size_}; }
+
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  operator std::string_view() const noexcept { return view(); }
+
+  [[nodiscard]] const char* data() const noexcept { return data_; }
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+ private:
+#if defined(_WIN32)
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), what};
+  }
+
+  void map(const std::string& path, const Options& /*options*/) {
+    const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) fail("Can't open " + path);
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+      CloseHandle(file);
+      fail("Can't get the size of " + path);
+    }
+    if (size.QuadPart == 0) {
+      CloseHandle(file);
+      return;
+    }
+
+    const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) fail("Can't map " + path);
+
+    const auto* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) fail("Can't map " + path);
+
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+  }
+
+  void unmap() noexcept {
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+  }
+#else
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::system_error{errno, std::generic_category(), what};
+  }
+
+  void map(const std::string& path, const Options& options) {
+    const auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file == -1) fail("Can't open " + path);
+
+    struct stat status {};
+    if (::fstat(file, &status) == -1) {
+      const auto error = errno;
+      ::close(file);
+      errno = error;
+      fail("Can't get the size of " + path);
+    }
+    if (status.st_size == 0) {
+      ::close(file);
+      return;
+    }
+
+    const auto size = static_cast<size_t>(status.st_size);
+    auto* const address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    const auto error = errno;
+    ::close(file);
+    errno = error;
+    if (address == MAP_FAILED) fail("Can't map " + path);
+
+    data_ = static_cast<const char*>(address);
+    size_ = size;
+
+    // The hints are only advice, the mapping works without them.
+    if (options.sequential) ::madvise(address, size, MADV_SEQUENTIAL);
+    if (options.will_need) ::madvise(address, size, MADV_WILLNEED);
+#if defined(MADV_HUGEPAGE)
+    if (options.huge_pages) ::madvise(address, size, MADV_HUGEPAGE);
+#endif
+  }
+
+  void unmap() noexcept {
+    if (data_ != nullptr) ::munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+
+  const char* data_{nullptr};
+  size_t size_{0};
+};
+
+/**
+ * @brief The result of parsing a file, together with the mapping it refers to.
+ */
+struct FileResult {
+  /** @brief The mapped file, which the result points into. */
+  MappedInput input;
+  /** @brief The result of parsing the whole file. */
+  Result result;
+
+  /** @brief Whether the parse was successful. */
+  explicit operator bool() const noexcept { return result.success; }
+};
+
+/**
+ * @brief Parse a file without reading it into memory first.
+ *
+ * The file is mapped with MappedInput and the parser applied to all of it.
+ *
+ * @throws std::system_error if the file can't be opened or mapped.
+ */
+template <class T>
+FileResult parse_file(const std::string& path, const BaseParser<T>& parser,
+                      const MappedInput::Options& options = {}) {
+  MappedInput input{path, options};
+  const auto result = input.view() >> parser;
+  return {std::move(input), result};
+}
+
+}  // namespace tiny_parse
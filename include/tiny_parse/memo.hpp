@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+/**
+ * @brief The memo table used for packrat parsing.
+ *
+ * Stores the results of Memo parsers keyed by rule id and input view in a flat open-addressing hash
+ * table. Entries are only valid for a single input, so the table has to be cleared before parsing a
+ * new one. Clearing is O(1), the storage is reused between inputs.
+ *
+ * A table isn't thread safe. Parsers using it must not be run by the parallel_* drivers, which
+ * parse from several threads at once, give every thread its own table and parser instead.
+ */
+class MemoTable {
+ public:
+  /**
+   * @brief A memoized parse result.
+   */
+  struct Entry {
+    /** @brief The position in the input at which the rule was parsed. */
+    const char* position;
+    /** @brief The end of the input the rule was parsed on. */
+    const char* end;
+    /** @brief The number of characters consumed by the parse. */
+    size_t consumed;
+    /** @brief The id of the parsed rule. */
+    uint32_t rule;
+    /** @brief The generation this entry was written in, 0 if it was never written. */
+    uint32_t generation;
+    /** @brief Whether the parse was successful. */
+    bool success;
+    /** @brief Whether the parse looked at the end of its input, see detail::reached_end. */
+    bool reached_end;
+  };
+
+  /**
+   * @brief Construct a memo table.
+   *
+   * @param capacity The initial number of entries, rounded up to a power of two.
+   */
+  explicit MemoTable(size_t capacity = 1024) {
+    size_t size = 16;
+    while (size < capacity) size *= 2;
+    entries_.resize(size);
+  }
+
+  /**
+   * @brief Reserve a new rule id.
+   *
+   * Every Memo parser takes one when it is constructed. Copies of a Memo parser share its id.
+   */
+  uint32_t add_rule() noexcept { return next_rule_++; }
+
+  /**
+   * @brief Forget all memoized results, e.g. before parsing a new input.
+   */
+  void clear() noexcept {
+    size_ = 0;
+    if (++generation_ != 0) return;
+
+    for (auto& entry : entries_) entry.generation = 0;
+    generation_ = 1;
+  }
+
+  /** @brief The number of memoized results. */
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief Look up the result of a rule on the input from position to end.
+   *
+   * Views that start at the same position, but end at different ones, have separate entries.
+   *
+   * @return const Entry* The memoized result, or nullptr if there is none.
+   */
+  [[nodiscard]] const Entry* find(uint32_t rule, const char* position,
+                                  const char* end) const noexcept {
+    const auto mask = entries_.size() - 1;
+    for (auto i = hash(rule, position, end) & mask;; i = (i + 1) & mask) {
+      const auto& entry = entries_[i];
+      if (entry.generation != generation_) return nullptr;
+      if (entry.rule == rule && entry.position == position && entry.end == end) return &entry;
+    }
+  }
+
+  /**
+   * @brief Memoize the result of a rule on the input from position to end.
+   */
+  void insert(uint32_t rule, const char* position, const char* end, size_t consumed, bool success,
+              bool reached_end) {
+    if (2 * (size_ + 1) > entries_.size()) grow();
+    place({position, end, consumed, rule, generation_, success, reached_end});
+    ++size_;
+  }
+
+ private:
+  static size_t hash(uint32_t rule, const char* position, const char* end) noexcept {
+    auto key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(position)) ^
+               (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(end)) << 24U) ^
+               (static_cast<uint64_t>(rule) << 48U);
+    key *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(key ^ (key >> 32U));
+  }
+
+  void place(const Entry& entry) noexcept {
+    const auto mask = entries_.size() - 1;
+    auto i = hash(entry.rule, entry.position, entry.end) & mask;
+    while (entries_[i].generation == generation_) i = (i + 1) & mask;
+    entries_[i] = entry;
+  }
+
+  void grow() {
+    auto old = std::move(entries_);
+    entries_ = std::vector<Entry>(old.size() * 2);
+    for (const auto& entry : old) {
+      if (entry.generation == generation_) place(entry);
+    }
+  }
+
+  std::vector<Entry> entries_;
+  size_t size_{0};
+  uint32_t generation_{1};
+  uint32_t next_rule_{0};
+};
+
+/**
+ * @brief A parser that memoizes the results of another parser.
+ *
+ * The result of the wrapped parser at every input position is stored in a MemoTable, so that
+ * backtracking alternatives which reach the same rule at the same position don't parse it again.
+ * Wrapping the rules of a grammar makes its parse time linear in the input size.
+ *
+ * Actions inside the memoized parser are only invoked when it is actually run, not when its result
+ * is taken from the table. Whether the parser looked at the end of its input is memoized as well,
+ * so Memo parsers work with StreamParser.
+ *
+ * @tparam T The parser to memoize.
+ */
+template <class T>
+class Memo : public BaseParser<Memo<T>> {
+ public:
+  static constexpr CharSet first = T::first;
+  static constexpr bool nullable = T::nullable;
+  static constexpr bool provably_nullable = T::provably_nullable;
+  static constexpr size_t min_width = T::min_width;
+  static constexpr size_t max_width = T::max_width;
+  static constexpr RequiredLiteral required = T::required;
+
+  Memo(const T& parser, MemoTable& table) noexcept
+      : parser_{parser}, table_{&table}, rule_{table.add_rule()} {}
+
+  [[nodiscard]] size_t min_length() const noexcept { return parser_.min_length(); }
+
+ protected:
+  friend class BaseParser<Memo>;
+
+  [[nodiscard]] Result parse_it(const std::string_view& sv) const {
+    const auto* end = sv.data() + sv.size();
+    if (const auto* entry = table_->find(rule_, sv.data(), end); entry != nullptr) {
+      if (entry->reached_end) detail::mark_end();
+      return entry->success ? Result{sv.substr(entry->consumed), true} : Result{sv, false};
+    }
+
+    // Find out whether this parse reaches the end on its own, without losing an earlier mark.
+    const auto reached_end_before = detail::reached_end;
+    detail::reached_end = false;
+    const auto result = parser_.parse(sv);
+    const auto reached_end = detail::reached_end;
+    detail::reached_end = reached_end_before || reached_end;
+
+    table_->insert(rule_, sv.data(), end, sv.size() - result.value.size(), result.success,
+                   reached_end);
+    return result;
+  }
+
+ private:
+  T parser_;
+  MemoTable* table_;
+  uint32_t rule_;
+};
+
+/** @relates Memo @brief Syntactic sugar for creating a Memo parser. */
+template <class T>
+Memo<T> memo(const T& parser, MemoTable& table) noexcept {
+  return Memo<T>{parser, table};
+}
+
+}  // namespace tiny_parse
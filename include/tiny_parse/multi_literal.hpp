@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+/**
+ * @brief Searches a buffer for any of a set of literal patterns.
+ *
+ * The patterns are compiled into an Aho–Corasick automaton, so the buffer is scanned once
+ * regardless of the number of patterns. States are numbered breadth-first; the shallow ones, which
+ * almost every input byte passes through, get a dense row of 256 transitions. Deeper states only
+ * store their own edges in sorted arrays and fall back along their failure links until they reach
+ * a dense state.
+ *
+ * Patterns are identified by their index in the order they were given. Overlapping matches and
+ * duplicate patterns are all reported.
+ */
+class MultiLiteralSearcher {
+ public:
+  /** @brief The default number of states with a dense transition row. */
+  static constexpr size_t default_dense_states = 128;
+
+  /**
+   * @brief Construct the searcher from a list of patterns.
+   *
+   * @throws std::invalid_argument if a pattern is empty.
+   */
+  MultiLiteralSearcher(std::initializer_list<std::string_view> patterns,
+                       size_t dense_states = default_dense_states)
+      : MultiLiteralSearcher(patterns.begin(), patterns.end(), dense_states) {}
+
+  /**
+   * @brief Construct the searcher from a range of patterns.
+   *
+   * @param dense_states The maximum number of states that get a dense transition row. Trades
+   * memory (1 KiB per state) for fewer failure link traversals.
+   * @throws std::invalid_argument if a pattern is empty.
+   */
+  template <class It>
+  MultiLiteralSearcher(It begin, It end, size_t dense_states = default_dense_states) {
+    build(trie_of(begin, end), std::max<size_t>(dense_states, 1));
+  }
+
+  /** @brief The number of patterns. */
+  [[nodiscard]] size_t size() const noexcept { return lengths_.size(); }
+
+  /** @brief The length of the pattern with the given id. */
+  [[nodiscard]] size_t pattern_length(size_t pattern) const noexcept { return lengths_[pattern]; }
+
+  /**
+   * @brief Report every occurrence of every pattern in the input.
+   *
+   * Matches are reported in the order in which they end, longer ones first.
+   *
+   * @param callback Invoked as `callback(pattern, offset)` with the id of the pattern and the
+   * offset of its first character in the input.
+   */
+  template <class Callback>
+  void search(std::string_view sv, Callback&& callback) const {
+    uint32_t state = 0;
+    for (size_t i = 0; i < sv.size(); ++i) {
+      state = next(state, static_cast<unsigned char>(sv[i]));
+      for (auto s = output_link_[state]; s != no_state; s = output_link_[fail_[s]]) {
+        for (auto o = outputs_begin_[s]; o != outputs_begin_[s + 1]; ++o) {
+          callback(size_t{outputs_[o]}, i + 1 - lengths_[outputs_[o]]);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Run a parser at every occurrence of a pattern and report where it succeeds.
+   *
+   * The patterns act as a prefilter: the parser is only tried at the offsets where one of them
+   * starts, and only once per offset.
+   *
+   * @param callback Invoked as `callback(pattern, offset, match)` with the id of the pattern, its
+   * offset in the input and the part of the input consumed by the parser.
+   */
+  template <class T, class Callback>
+  void search(std::string_view sv, const BaseParser<T>& parser, Callback&& callback) const {
+    // Matches are reported by their end, so the same offset may come up again after others. All
+    // matches ending at a position start within the longest pattern before it, so the results of
+    // that many offsets are kept, each in the slot of its offset modulo the longest pattern.
+    struct Parsed {
+      size_t offset;
+      Result result;
+    };
+    std::vector<Parsed> parsed(longest_, Parsed{std::numeric_limits<size_t>::max(), Result{}});
+
+    search(sv, [&](size_t pattern, size_t offset) {
+      auto& [parsed_offset, result] = parsed[offset % longest_];
+      if (parsed_offset != offset) {
+        parsed_offset = offset;
+        result = parser.parse(sv.substr(offset));
+      }
+      if (!result) return;
+
+      const auto length = sv.size() - offset - result.value.size();
+      callback(pattern, offset, sv.substr(offset, length));
+    });
+  }
+
+ private:
+  static constexpr uint32_t no_state = std::numeric_limits<uint32_t>::max();
+
+  /** @brief The patterns as a trie, before the states are renumbered. */
+  struct Trie {
+    std::vector<std::map<unsigned char, uint32_t>> children;
+    std::vector<std::vector<uint32_t>> outputs;
+  };
+
+  template <class It>
+  Trie trie_of(It begin, It end) {
+    Trie trie{{{}}, {{}}};
+
+    for (auto it = begin; it != end; ++it) {
+      const std::string_view pattern = *it;
+      if (pattern.empty()) {
+        throw std::invalid_argument{"MultiLiteralSearcher can't search for an empty pattern"};
+      }
+
+      uint32_t node = 0;
+      for (const auto c : pattern) {
+        const auto [child, inserted] = trie.children[node].try_emplace(
+            static_cast<unsigned char>(c), static_cast<uint32_t>(trie.children.size()));
+        if (inserted) {
+          trie.children.emplace_back();
+          trie.outputs.emplace_back();
+        }
+        node = child->second;
+      }
+      trie.outputs[node].push_back(static_cast<uint32_t>(lengths_.size()));
+      lengths_.push_back(pattern.size());
+      longest_ = std::max(longest_, pattern.size());
+    }
+    return trie;
+  }
+
+  void build(const Trie& trie, size_t dense_states) {
+    // Renumber the states breadth-first, so that shallow states have the smallest ids.
+    std::vector<uint32_t> order{0};
+    std::vector<uint32_t> id(trie.children.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      for (const auto& [c, child] : trie.children[order[i]]) {
+        id[child] = static_cast<uint32_t>(order.size());
+        order.push_back(child);
+      }
+    }
+
+    const auto states = order.size();
+    dense_states_ = static_cast<uint32_t>(std::min(dense_states, states));
+    fail_.assign(states, 0);
+    output_link_.assign(states, no_state);
+    edges_begin_.reserve(states + 1);
+    outputs_begin_.reserve(states + 1);
+
+    for (const auto node : order) {
+      edges_begin_.push_back(static_cast<uint32_t>(edge_chars_.size()));
+      for (const auto& [c, child] : trie.children[node]) {
+        edge_chars_.push_back(c);
+        edge_targets_.push_back(id[child]);
+      }
+      outputs_begin_.push_back(static_cast<uint32_t>(outputs_.size()));
+      outputs_.insert(outputs_.end(), trie.outputs[node].begin(), trie.outputs[node].end());
+    }
+    edges_begin_.push_back(static_cast<uint32_t>(edge_chars_.size()));
+    outputs_begin_.push_back(static_cast<uint32_t>(outputs_.size()));
+
+    // The failure link of a state is the longest proper suffix of its string that is also a
+    // state. Parents come first in breadth-first order, so their links are already known.
+    dense_.assign(dense_states_ * size_t{256}, 0);
+    for (uint32_t state = 0; state < states; ++state) {
+      if (outputs_begin_[state] != outputs_begin_[state + 1]) {
+        output_link_[state] = state;
+      } else if (state != 0) {
+        output_link_[state] = output_link_[fail_[state]];
+      }
+
+      for (auto e = edges_begin_[state]; e != edges_begin_[state + 1]; ++e) {
+        const auto child = edge_targets_[e];
+        fail_[child] = state == 0 ? 0 : next(fail_[state], edge_chars_[e]);
+      }
+
+      if (state >= dense_states_) continue;
+      auto* row = &dense_[state * size_t{256}];
+      if (state != 0) std::copy_n(&dense_[fail_[state] * size_t{256}], 256, row);
+      for (auto e = edges_begin_[state]; e != edges_begin_[state + 1]; ++e) {
+        row[edge_chars_[e]] = edge_targets_[e];
+      }
+    }
+  }
+
+  /** @brief The state reached from the given state by the given character. */
+  [[nodiscard]] uint32_t next(uint32_t state, unsigned char c) const noexcept {
+    while (state >= dense_states_) {
+      const auto* begin = edge_chars_.data() + edges_begin_[state];
+      const auto* end = edge_chars_.data() + edges_begin_[state + 1];
+      const auto* edge =
+          end - begin <= 8 ? std::find(begin, end, c) : std::lower_bound(begin, end, c);
+      if (edge != end && *edge == c) {
+        return edge_targets_[static_cast<size_t>(edge - edge_chars_.data())];
+      }
+      state = fail_[state];
+    }
+    return dense_[state * size_t{256} + c];
+  }
+
+  /** @brief The number of states with a dense transition row, they have the smallest ids. */
+  uint32_t dense_states_{1};
+  /** @brief The transitions of the dense states, 256 per state. */
+  std::vector<uint32_t> dense_;
+  /** @brief The start of the edges of each state, followed by the total number of edges. */
+  std::vector<uint32_t> edges_begin_;
+  /** @brief The characters of the edges, sorted per state. */
+  std::vector<unsigned char> edge_chars_;
+  /** @brief The target states of the edges. */
+  std::vector<uint32_t> edge_targets_;
+  /** @brief The failure link of each state. */
+  std::vector<uint32_t> fail_;
+  /** @brief The nearest state on the failure chain, including itself, where a pattern ends. */
+  std::vector<uint32_t> output_link_;
+  /** @brief The start of the pattern ids of each state, followed by the total number of ids. */
+  std::vector<uint32_t> outputs_begin_;
+  /** @brief The ids of the patterns ending in each state. */
+  std::vector<uint32_t> outputs_;
+  /** @brief The length of each pattern. */
+  std::vector<size_t> lengths_;
+  /** @brief The length of the longest pattern. */
+  size_t longest_{0};
+};
+
+}  // namespace tiny_parse
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "scan.hpp"
+#include "tiny_parse.hpp"
+
+namespace tiny_parse::detail {
+
+/** @brief Eight copies of a byte, one in each byte of a word. */
+constexpr uint64_t broadcast(uint8_t byte) noexcept { return 0x0101010101010101ULL * byte; }
+
+/** @brief Load 8 characters into a word, the first one in the lowest byte. */
+inline uint64_t load_word(const char* data) noexcept {
+  uint64_t word{};
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/**
+ * @brief Load up to 8 characters into the highest bytes of a word, with '0' in the bytes below.
+ *
+ * Leading zeros don't change the value of a number, so the word can be converted like 8 digits.
+ */
+inline uint64_t load_padded(const char* data, size_t count) noexcept {
+  std::array<char, 8> chars{'0', '0', '0', '0', '0', '0', '0', '0'};
+  std::memcpy(chars.data() + 8 - count, data, count);
+  return load_word(chars.data());
+}
+
+/** @brief A word with the highest bit set in every byte that isn't a decimal digit. */
+constexpr uint64_t non_digit_mask(uint64_t word) noexcept {
+  const auto low = word & broadcast(0x7F);
+  const auto above = low + broadcast(0x7F - '9');
+  const auto below = broadcast(0x7F + '0') - low;
+  return (word | above | below) & broadcast(0x80);
+}
+
+/**
+ * @brief The value of 8 decimal digits, the first one in the lowest byte.
+ *
+ * Combines pairs of digits, then pairs of pairs and so on, with three multiplications in total.
+ */
+constexpr uint32_t parse_eight_digits(uint64_t word) noexcept {
+  word -= broadcast('0');
+  word = word * 10 + (word >> 8);
+  word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+          (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+         32;
+  return static_cast<uint32_t>(word);
+}
+
+inline constexpr std::array<uint64_t, 9> powers_of_ten{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+/** @brief The largest value that can be followed by i more digits without overflowing. */
+inline constexpr auto overflow_limits = [] {
+  std::array<uint64_t, 9> limits{};
+  for (size_t i = 0; i < limits.size(); ++i) {
+    limits[i] = std::numeric_limits<uint64_t>::max() / powers_of_ten[i];
+  }
+  return limits;
+}();
+
+/** @brief The largest i digits that can follow overflow_limits[i] without overflowing. */
+inline constexpr auto overflow_remainders = [] {
+  std::array<uint64_t, 9> remainders{};
+  for (size_t i = 0; i < remainders.size(); ++i) {
+    remainders[i] = std::numeric_limits<uint64_t>::max() % powers_of_ten[i];
+  }
+  return remainders;
+}();
+
+/** @brief A run of decimal digits at the start of an input and its value. */
+struct DigitRun {
+  /** @brief The number of digits. */
+  size_t length{};
+  /** @brief The value of the digits, if it fits into 64 bits. */
+  uint64_t value{};
+  /** @brief Whether the value doesn't fit into 64 bits. The length is unspecified then. */
+  bool overflow{};
+
+  /** @brief Append count digits with the given value, checking for overflow. */
+  constexpr void append(uint64_t digits, size_t count) noexcept {
+    const auto limit = overflow_limits[count];
+    if (value > limit || (value == limit && digits > overflow_remainders[count])) {
+      overflow = true;
+      return;
+    }
+    value = value * powers_of_ten[count] + digits;
+    length += count;
+  }
+};
+
+constexpr bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+/**
+ * @brief The digits in a word, converted, see scan_digits.
+ *
+ * @return size_t The number of digits at the start of the word, its value is added to the run.
+ */
+constexpr size_t append_word(DigitRun& run, uint64_t word) noexcept {
+  const auto non_digits = non_digit_mask(word);
+  const size_t count = non_digits == 0 ? 8 : count_trailing_zeros(non_digits) / 8;
+  if (count == 0) return 0;
+  // Move the digits to the top of the word and pad them with leading zeros.
+  if (count < 8) word = (word << (8 * (8 - count))) | (broadcast('0') >> (8 * count));
+  run.append(parse_eight_digits(word), count);
+  return count;
+}
+
+/** @brief Continue scanning a run of digits after its first 8 digits, see scan_digits. */
+inline DigitRun scan_more_digits(const std::string_view& sv, DigitRun run) noexcept {
+  while (run.length < sv.size() && !run.overflow) {
+    // Near the end, load the last 8 characters and shift out the ones already consumed.
+    const auto rest = sv.size() - run.length;
+    const auto word = rest >= 8 ? load_word(sv.data() + run.length)
+                                : load_word(sv.data() + sv.size() - 8) >> (8 * (8 - rest));
+    if (append_word(run, word) < 8) break;
+  }
+  return run;
+}
+
+/**
+ * @brief Scan the decimal digits at the start of the input and convert them in the same pass.
+ *
+ * The input is processed 8 characters at a time: the digits in a word are found with a SWAR
+ * comparison and converted with parse_eight_digits. Numbers of up to 7 digits take a single word
+ * and no loop, longer ones continue in scan_more_digits. Only inputs shorter than 8 characters are
+ * handled one character at a time.
+ */
+constexpr DigitRun scan_digits(const std::string_view& sv) noexcept {
+  DigitRun run;
+  if (TINY_PARSE_LITTLE_ENDIAN && !is_constant_evaluated() && sv.size() >= 8) {
+    if (append_word(run, load_word(sv.data())) < 8) return run;
+    return scan_more_digits(sv, run);
+  }
+  for (; run.length < sv.size() && is_digit(sv[run.length]) && !run.overflow;) {
+    const auto digit = static_cast<uint64_t>(sv[run.length] - '0');
+    // Up to 19 digits always fit, only longer runs have to be checked.
+    if (run.length < 19) {
+      run.value = run.value * 10 + digit;
+      ++run.length;
+    } else {
+      run.append(digit, 1);
+    }
+  }
+  return run;
+}
+
+/** @brief The value of a hexadecimal digit, or 16 if the character isn't one. */
+constexpr uint8_t hex_value(char c) noexcept {
+  if (c >= '0' && c <= '9') return static_cast<uint8_t>(c - '0');
+  if (c >= 'a' && c <= 'f') return static_cast<uint8_t>(c - 'a' + 10);
+  if (c >= 'A' && c <= 'F') return static_cast<uint8_t>(c - 'A' + 10);
+  return 16;
+}
+
+/** @brief The first set of a decimal number. */
+inline constexpr CharSet decimal_digits = CharSet::range('0', '9');
+
+}  // namespace tiny_parse::detail
+
+namespace tiny_parse::built_in {
+
+/**
+ * @brief A parser for an unsigned decimal integer that produces its value.
+ *
+ * Validation and conversion happen in the same pass over the input, 8 digits at a time, see
+ * detail::scan_digits. The parser consumes all digits at the start of the input and fails if there
+ * are none, or if their value doesn't fit into T or lies outside of [Min, Max]. It doesn't give
+ * back digits to get a value in range, so `uint_<uint8_t>` fails on "1000" instead of parsing
+ * "100".
+ *
+ * @tparam T The unsigned integer type of the value.
+ * @tparam Min The smallest accepted value.
+ * @tparam Max The largest accepted value.
+ */
+template <class T, T Min = std::numeric_limits<T>::min(), T Max = std::numeric_limits<T>::max()>
+class UIntP : public BaseParser<UIntP<T, Min, Max>> {
+  static_assert(std::is_unsigned_v<T>, "UIntP needs an unsigned integer type");
+  static_assert(Min <= Max, "The range of a UIntP parser must not be empty");
+
+ public:
+  using attribute_type = T;
+
+  static constexpr CharSet first = tiny_parse::detail::decimal_digits;
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+ protected:
+  friend class BaseParser<UIntP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    T value{};
+    return parse_it(sv, value);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    const auto run = tiny_parse::detail::scan_digits(sv);
+    if (run.overflow) return {sv, false};
+    if (run.length == sv.size()) tiny_parse::detail::mark_end();
+    if (run.length == 0 || run.value < Min || run.value > Max) return {sv, false};
+
+    attribute = static_cast<T>(run.value);
+    return {sv.substr(run.length), true};
+  }
+};
+
+/**
+ * @brief A parser for a signed decimal integer that produces its value.
+ *
+ * Like UIntP, preceded by an optional '-' or '+' sign.
+ *
+ * @tparam T The signed integer type of the value.
+ * @tparam Min The smallest accepted value.
+ * @tparam Max The largest accepted value.
+ */
+template <class T, T Min = std::numeric_limits<T>::min(), T Max = std::numeric_limits<T>::max()>
+class IntP : public BaseParser<IntP<T, Min, Max>> {
+  static_assert(std::is_signed_v<T> && std::is_integral_v<T>, "IntP needs a signed integer type");
+  static_assert(Min <= Max, "The range of an IntP parser must not be empty");
+
+ public:
+  using attribute_type = T;
+
+  static constexpr CharSet first =
+      tiny_parse::detail::decimal_digits | CharSet::single('-') | CharSet::single('+');
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+ protected:
+  friend class BaseParser<IntP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    T value{};
+    return parse_it(sv, value);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    const bool negative = !sv.empty() && sv.front() == '-';
+    const size_t sign = (negative || (!sv.empty() && sv.front() == '+')) ? 1 : 0;
+    const auto run = tiny_parse::detail::scan_digits(sv.substr(sign));
+    if (run.overflow) return {sv, false};
+    if (sign + run.length == sv.size()) tiny_parse::detail::mark_end();
+    if (run.length == 0) return {sv, false};
+
+    // The magnitude of the most negative value is one more than the largest value.
+    constexpr auto max_magnitude = static_cast<uint64_t>(std::numeric_limits<T>::max());
+    if (run.value > max_magnitude + (negative ? 1 : 0)) return {sv, false};
+
+    using Unsigned = std::make_unsigned_t<T>;
+    const auto magnitude = static_cast<Unsigned>(run.value);
+    const auto value = static_cast<T>(negative ? static_cast<Unsigned>(Unsigned{0} - magnitude)
+                                               : magnitude);
+    if (value < Min || value > Max) return {sv, false};
+
+    attribute = value;
+    return {sv.substr(sign + run.length), true};
+  }
+};
+
+/**
+ * @brief A parser for an unsigned hexadecimal integer, without prefix, that produces its value.
+ *
+ * Accepts upper and lower case digits. Like UIntP, it consumes all digits at the start of the input
+ * and fails if their value doesn't fit into T.
+ *
+ * @tparam T The unsigned integer type of the value.
+ */
+template <class T>
+class HexP : public BaseParser<HexP<T>> {
+  static_assert(std::is_unsigned_v<T>, "HexP needs an unsigned integer type");
+
+ public:
+  using attribute_type = T;
+
+  static constexpr CharSet first = tiny_parse::detail::decimal_digits |
+                                   CharSet::range('a', 'f') | CharSet::range('A', 'F');
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 1; }
+
+ protected:
+  friend class BaseParser<HexP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    T value{};
+    return parse_it(sv, value);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    constexpr auto bits = std::numeric_limits<T>::digits;
+    T value{};
+    size_t i = 0;
+    for (; i < sv.size(); ++i) {
+      const auto digit = tiny_parse::detail::hex_value(sv[i]);
+      if (digit == 16) break;
+      if ((value >> (bits - 4)) != 0) return {sv, false};
+      value = static_cast<T>((value << 4U) | digit);
+    }
+    if (i == sv.size()) tiny_parse::detail::mark_end();
+    if (i == 0) return {sv, false};
+
+    attribute = value;
+    return {sv.substr(i), true};
+  }
+};
+
+/**
+ * @brief A parser for exactly N decimal digits that produces their value.
+ *
+ * For fixed-width fields like the year of a date, where `4 * digit` would only validate. The
+ * length is checked once up front, and the digits are validated and converted 8 at a time.
+ *
+ * @tparam N The number of digits.
+ * @tparam T The integer type of the value, it has to hold any N digits.
+ */
+template <size_t N, class T>
+class DigitsP : public BaseParser<DigitsP<N, T>> {
+  static_assert(N > 0, "A DigitsP parser needs at least one digit");
+  static_assert(N <= static_cast<size_t>(std::numeric_limits<T>::digits10),
+                "The value of the digits has to fit into T");
+
+ public:
+  using attribute_type = T;
+
+  static constexpr CharSet first = tiny_parse::detail::decimal_digits;
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = N;
+  static constexpr size_t max_width = N;
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return N; }
+
+ protected:
+  friend class BaseParser<DigitsP>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    T value{};
+    return parse_it(sv, value);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    if (sv.size() < N) {
+      if (tiny_parse::detail::scan_digits(sv).length == sv.size()) tiny_parse::detail::mark_end();
+      return {sv, false};
+    }
+
+    uint64_t value = 0;
+    if (TINY_PARSE_LITTLE_ENDIAN && !tiny_parse::detail::is_constant_evaluated()) {
+      constexpr size_t head = N % 8;
+      if constexpr (head != 0) {
+        const auto word = tiny_parse::detail::load_padded(sv.data(), head);
+        if (tiny_parse::detail::non_digit_mask(word) != 0) return {sv, false};
+        value = tiny_parse::detail::parse_eight_digits(word);
+      }
+      for (size_t i = head; i < N; i += 8) {
+        const auto word = tiny_parse::detail::load_word(sv.data() + i);
+        if (tiny_parse::detail::non_digit_mask(word) != 0) return {sv, false};
+        value = value * 100000000 + tiny_parse::detail::parse_eight_digits(word);
+      }
+    } else {
+      for (size_t i = 0; i < N; ++i) {
+        if (!tiny_parse::detail::is_digit(sv[i])) return {sv, false};
+        value = value * 10 + static_cast<uint64_t>(sv[i] - '0');
+      }
+    }
+
+    attribute = static_cast<T>(value);
+    return {sv.substr(N), true};
+  }
+};
+
+/** @brief An unsigned decimal integer of type T in [Min, Max], see UIntP. */
+template <class T = unsigned, T Min = std::numeric_limits<T>::min(),
+          T Max = std::numeric_limits<T>::max()>
+inline constexpr UIntP<T, Min, Max> uint_{};
+
+/** @brief A signed decimal integer of type T in [Min, Max], see IntP. */
+template <class T = int, T Min = std::numeric_limits<T>::min(),
+          T Max = std::numeric_limits<T>::max()>
+inline constexpr IntP<T, Min, Max> int_{};
+
+/** @brief An unsigned hexadecimal integer of type T, see HexP. */
+template <class T = unsigned>
+inline constexpr HexP<T> hex_{};
+
+/** @brief Exactly N decimal digits, as an integer of type T, see DigitsP. */
+template <size_t N, class T = unsigned>
+inline constexpr DigitsP<N, T> digits{};
+
+}  // namespace tiny_parse::built_in
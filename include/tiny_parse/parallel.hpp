@@ -0,0 +1,404 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "scan.hpp"
+#include "thread_pool.hpp"
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+/** @brief The result of parsing a buffer of records in parallel. */
+struct RecordsResult {
+  /** @brief The number of records parsed before the first one that failed. */
+  size_t records{0};
+  /** @brief The offset of the first record that failed to parse, or npos if all of them parsed. */
+  size_t error_offset{std::string_view::npos};
+
+  /** @brief Whether all records were parsed successfully. */
+  constexpr explicit operator bool() const noexcept {
+    return error_offset == std::string_view::npos;
+  }
+};
+
+namespace detail {
+
+/** @brief The smallest part of a buffer worth handing to a thread of its own. */
+inline constexpr size_t min_chunk_size = size_t{64} * 1024;
+
+/**
+ * @brief Split a buffer into about `count` chunks that start at record boundaries.
+ *
+ * @return std::vector<size_t> The offsets of the chunks, followed by the size of the buffer.
+ */
+inline std::vector<size_t> split_records(const std::string_view& buffer, char delimiter,
+                                         size_t count) {
+  std::vector<size_t> offsets{0};
+  for (size_t i = 1; i < count; ++i) {
+    const auto guess = std::max(buffer.size() / count * i, offsets.back());
+    const auto delimiter_at = buffer.find(delimiter, guess);
+    if (delimiter_at == std::string_view::npos) break;
+    offsets.push_back(delimiter_at + 1);
+  }
+  offsets.push_back(buffer.size());
+  return offsets;
+}
+
+/**
+ * @brief The records of a chunk and the state of parsing them.
+ */
+template <class Sink>
+struct ChunkState {
+  Sink sink{};
+  size_t records{0};
+  size_t error_offset{std::string_view::npos};
+};
+
+/**
+ * @brief Parse the records in a chunk of a buffer, up to the first one that fails.
+ *
+ * The delimiter after the last record is optional. Every record has to be consumed completely.
+ *
+ * @param record_end Invoked as `record_end(chunk, from)`, returns the position of the delimiter
+ * that ends the record starting at `from`, or npos if the record extends to the end of the chunk.
+ */
+template <class T, class Sink, class RecordEnd>
+void parse_chunk(const std::string_view& buffer, size_t begin, size_t end,
+                 const BaseParser<T>& parser, const RecordEnd& record_end,
+                 ChunkState<Sink>& state) {
+  const auto chunk = buffer.substr(begin, end - begin);
+  for (size_t i = 0; i < chunk.size();) {
+    const auto record = chunk.substr(i, std::min(record_end(chunk, i), chunk.size()) - i);
+    if (const auto result = parser.parse(record); !result || !result.value.empty()) {
+      state.error_offset = begin + i;
+      return;
+    }
+    state.sink(record);
+    ++state.records;
+    i += record.size() + 1;
+  }
+}
+
+/**
+ * @brief Parse the chunks of a buffer concurrently and merge their sinks in order.
+ *
+ * @param offsets The offsets of the chunks, which start at record boundaries, followed by the
+ * size of the buffer.
+ */
+template <class T, class Sink, class RecordEnd>
+RecordsResult parse_chunks(const std::string_view& buffer, const std::vector<size_t>& offsets,
+                           const BaseParser<T>& parser, const RecordEnd& record_end, Sink& sink,
+                           ThreadPool& pool) {
+  std::vector<ChunkState<Sink>> chunks(offsets.size() - 1);
+  // Chunks after one with an error won't be merged, so they are skipped if they haven't started.
+  std::atomic<size_t> first_error{chunks.size()};
+  pool.parallel_for(chunks.size(), [&](size_t i) {
+    if (i > first_error.load(std::memory_order_relaxed)) return;
+    parse_chunk(buffer, offsets[i], offsets[i + 1], parser, record_end, chunks[i]);
+    if (chunks[i].error_offset == std::string_view::npos) return;
+    for (auto error = first_error.load(); i < error;) {
+      if (first_error.compare_exchange_weak(error, i)) break;
+    }
+  });
+
+  RecordsResult result;
+  for (auto& chunk : chunks) {
+    sink.merge(std::move(chunk.sink));
+    result.records += chunk.records;
+    if (chunk.error_offset != std::string_view::npos) {
+      result.error_offset = chunk.error_offset;
+      break;
+    }
+  }
+  return result;
+}
+
+/** @brief The number of chunks to split a buffer into for the given pool. */
+inline size_t chunk_count(const std::string_view& buffer, const ThreadPool& pool) noexcept {
+  return std::clamp<size_t>(buffer.size() / min_chunk_size, 1, 4 * pool.concurrency());
+}
+
+/**
+ * @brief What a chunk of a quoted buffer looks like, without knowing whether it starts in quotes.
+ */
+struct QuoteSummary {
+  /** @brief Whether the chunk has an odd number of quotes. */
+  bool odd_quotes{false};
+  /**
+   * @brief The position of the first delimiter outside quotes, if the chunk starts outside
+   * (index 0) or inside (index 1) quotes, or npos if there is none.
+   */
+  std::array<size_t, 2> first_delimiter{std::string_view::npos, std::string_view::npos};
+};
+
+/** @brief Summarize a chunk, see QuoteSummary. */
+inline QuoteSummary summarize_quotes(const std::string_view& chunk, char delimiter, char quote) {
+  QuoteSummary summary;
+  // Whether the number of quotes so far is odd. A delimiter is outside quotes if the chunk starts
+  // in the state that makes the total even.
+  size_t odd = 0;
+  size_t i = 0;
+  for (; (i = find_either(chunk, delimiter, quote, i)) != std::string_view::npos; ++i) {
+    if (chunk[i] == quote) {
+      odd ^= 1U;
+      continue;
+    }
+    auto& first = summary.first_delimiter[odd];
+    if (first == std::string_view::npos) first = i;
+    if (summary.first_delimiter[odd ^ 1U] != std::string_view::npos) break;
+  }
+  if (i != std::string_view::npos) {
+    odd ^= static_cast<size_t>(std::count(chunk.begin() + static_cast<std::ptrdiff_t>(i),
+                                          chunk.end(), quote)) & 1U;
+  }
+  summary.odd_quotes = odd != 0;
+  return summary;
+}
+
+/** @brief The end of a record in a buffer where delimiters in quotes don't count. */
+struct QuotedRecordEnd {
+  char delimiter;
+  char quote;
+
+  size_t operator()(const std::string_view& chunk, size_t from) const noexcept {
+    bool in_quotes = false;
+    for (auto i = from; (i = find_either(chunk, delimiter, quote, i)) != std::string_view::npos;
+         ++i) {
+      if (chunk[i] == quote) {
+        in_quotes = !in_quotes;
+      } else if (!in_quotes) {
+        return i;
+      }
+    }
+    return std::string_view::npos;
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Parse a buffer of delimited records on a thread pool.
+ *
+ * The buffer is split into chunks at record boundaries, found with a memchr scan for the delimiter
+ * starting from evenly spaced offsets. The chunks are parsed concurrently with the same parser,
+ * which has to consume each record completely and must not have side effects that aren't safe
+ * across threads, e.g. actions writing to shared state.
+ *
+ * Each chunk collects its records in a sink of its own. When all chunks are done, the chunk sinks
+ * are merged into the given sink in the order of the chunks, so the sink sees the records in the
+ * order of the buffer. Parsing stops at the first record that fails: only the records before it are
+ * merged.
+ *
+ * @param sink Receives the records. Sink has to be default constructible, invocable with a record
+ * as `std::string_view`, and provide `merge(Sink&&)`, which appends the records of another sink.
+ */
+template <class T, class Sink>
+RecordsResult parallel_parse_records(const std::string_view& buffer, char delimiter,
+                                     const BaseParser<T>& parser, Sink& sink,
+                                     ThreadPool& pool = ThreadPool::shared()) {
+  const auto offsets = detail::split_records(buffer, delimiter, detail::chunk_count(buffer, pool));
+  const auto record_end = [delimiter](const std::string_view& chunk, size_t from) {
+    return chunk.find(delimiter, from);
+  };
+  return detail::parse_chunks(buffer, offsets, parser, record_end, sink, pool);
+}
+
+/**
+ * @brief Parse a buffer of delimited records, which may contain quoted delimiters, on a thread
+ * pool.
+ *
+ * Like parallel_parse_records, but delimiters between quotes, e.g. newlines in quoted CSV fields,
+ * don't end a record. An escaped quote has to be written as two quotes, as in CSV, so that quotes
+ * always come in pairs.
+ *
+ * Whether an offset is inside quotes depends on everything before it, so the buffer is split in
+ * two passes. First, evenly sized chunks are summarized concurrently: the parity of their quotes
+ * and their first delimiter for either possible start state. Then a prefix pass over the summaries
+ * finds the state each chunk really starts in, and with it the first true record boundary in each
+ * chunk, at which the records are parsed concurrently as before.
+ *
+ * @param quote The quote character.
+ */
+template <class T, class Sink>
+RecordsResult parallel_parse_quoted_records(const std::string_view& buffer, char delimiter,
+                                            char quote, const BaseParser<T>& parser, Sink& sink,
+                                            ThreadPool& pool = ThreadPool::shared()) {
+  const auto count = detail::chunk_count(buffer, pool);
+  std::vector<detail::QuoteSummary> summaries(count);
+  pool.parallel_for(count, [&](size_t i) {
+    const auto begin = buffer.size() / count * i;
+    const auto end = i + 1 == count ? buffer.size() : buffer.size() / count * (i + 1);
+    summaries[i] = detail::summarize_quotes(buffer.substr(begin, end - begin), delimiter, quote);
+  });
+
+  std::vector<size_t> offsets{0};
+  bool in_quotes = false;
+  for (size_t i = 0; i < count; ++i) {
+    const auto& summary = summaries[i];
+    const auto delimiter_at = summary.first_delimiter[in_quotes ? 1 : 0];
+    if (i != 0 && delimiter_at != std::string_view::npos) {
+      offsets.push_back(buffer.size() / count * i + delimiter_at + 1);
+    }
+    in_quotes ^= summary.odd_quotes;
+  }
+  offsets.push_back(buffer.size());
+
+  return detail::parse_chunks(buffer, offsets, parser, detail::QuotedRecordEnd{delimiter, quote},
+                              sink, pool);
+}
+
+/** @brief The callback of a ParMany parser that does nothing with the elements. */
+struct IgnoreElements {
+  constexpr void operator()(std::string_view /*unused*/) const noexcept {}
+};
+
+/**
+ * @brief A parser that matches separator-terminated elements in parallel.
+ *
+ * Behaves like `*(element & separator)` for elements that don't contain the separator, which has
+ * to be a character class. The input is cut into chunks at separators found with a vectorized scan,
+ * see detail::find_first, and the elements of the chunks are parsed on a thread pool. Each element
+ * has to be consumed completely. Like Many, the repetition stops before the first element that
+ * fails to parse or isn't terminated by a separator, and succeeds.
+ *
+ * The callback is invoked for every parsed element in the order of the input, on the thread that
+ * parses the ParMany, after all elements are parsed: with the element's input, or, if it isn't
+ * invocable with that and the element parser produces a value (see BaseParser::parse), with its
+ * value. Actions inside the element parser run concurrently on the pool instead.
+ *
+ * @tparam P The parser for the elements.
+ * @tparam Sep The character class that terminates the elements.
+ * @tparam F The callback for the elements.
+ */
+template <class P, class Sep, class F = IgnoreElements>
+class ParMany : public BaseParser<ParMany<P, Sep, F>> {
+  static_assert(is_char_class_v<Sep>,
+                "The separator of a ParMany parser has to be a character class");
+
+ public:
+  static constexpr CharSet first = P::first;
+  static constexpr bool nullable = true;
+  static constexpr bool provably_nullable = true;
+
+  ParMany(const P& element, const Sep& /*separator*/, const F& callback = {},
+          ThreadPool& pool = ThreadPool::shared())
+      : element_{element}, callback_{callback}, pool_{&pool} {}
+
+  [[nodiscard]] size_t min_length() const noexcept { return 0; }
+
+ protected:
+  friend class BaseParser<ParMany>;
+
+  [[nodiscard]] Result parse_it(const std::string_view& sv) const {
+    const auto offsets = split(sv);
+    std::vector<Chunk> chunks(offsets.size() - 1);
+    if (chunks.size() == 1) {
+      parse_chunk(sv, offsets[0], offsets[1], chunks[0]);
+    } else {
+      std::atomic<size_t> first_stop{chunks.size()};
+      pool_->parallel_for(chunks.size(), [&](size_t i) {
+        if (i > first_stop.load(std::memory_order_relaxed)) return;
+        parse_chunk(sv, offsets[i], offsets[i + 1], chunks[i]);
+        if (chunks[i].stop == std::string_view::npos) return;
+        for (auto stop = first_stop.load(); i < stop;) {
+          if (first_stop.compare_exchange_weak(stop, i)) break;
+        }
+      });
+    }
+
+    auto end = sv.size();
+    for (auto& chunk : chunks) {
+      for (auto& value : chunk.values) callback_(std::move(value));
+      if (chunk.stop != std::string_view::npos) {
+        end = chunk.stop;
+        break;
+      }
+    }
+    // More input could continue the repetition, or terminate the element it stopped at.
+    if (end == sv.size() || detail::find_first<Sep>(sv.substr(end)) == sv.size() - end) {
+      detail::mark_end();
+    }
+    return {sv.substr(end), true};
+  }
+
+ private:
+  static constexpr bool by_value = !std::is_invocable_v<const F&, std::string_view>;
+
+  using Value = std::conditional_t<by_value, attribute_of_t<P>, std::string_view>;
+
+  struct Chunk {
+    /** @brief The values of the parsed elements, in order. */
+    std::vector<Value> values;
+    /** @brief The offset of the element the repetition stops at, or npos. */
+    size_t stop{std::string_view::npos};
+  };
+
+  /** @brief Cut the input into chunks that start after a separator. */
+  [[nodiscard]] std::vector<size_t> split(const std::string_view& sv) const {
+    const auto count =
+        std::clamp<size_t>(sv.size() / detail::min_chunk_size, 1, 4 * pool_->concurrency());
+    std::vector<size_t> offsets{0};
+    for (size_t i = 1; i < count; ++i) {
+      const auto guess = std::max(sv.size() / count * i, offsets.back());
+      const auto separator_at = guess + detail::find_first<Sep>(sv.substr(guess));
+      if (separator_at == sv.size()) break;
+      offsets.push_back(separator_at + 1);
+    }
+    offsets.push_back(sv.size());
+    return offsets;
+  }
+
+  void parse_chunk(const std::string_view& sv, size_t begin, size_t end, Chunk& chunk) const {
+    const auto input = sv.substr(0, end);
+    for (auto i = begin; i < end;) {
+      const auto separator_at = i + detail::find_first<Sep>(input.substr(i));
+      if (separator_at == sv.size()) {
+        chunk.stop = i;
+        return;
+      }
+
+      const auto element = sv.substr(i, separator_at - i);
+      Value value{};
+      Result result;
+      if constexpr (by_value) {
+        result = element_.parse(element, value);
+      } else {
+        result = element_.parse(element);
+        value = element;
+      }
+      if (!result || !result.value.empty()) {
+        chunk.stop = i;
+        return;
+      }
+
+      if constexpr (!std::is_same_v<F, IgnoreElements>) chunk.values.push_back(std::move(value));
+      i = separator_at + 1;
+    }
+  }
+
+  P element_;
+  F callback_;
+  ThreadPool* pool_;
+};
+
+/** @relates ParMany @brief Syntactic sugar for creating a ParMany parser. */
+template <class P, class Sep>
+ParMany<P, Sep> par_many(const P& element, const Sep& separator) {
+  return ParMany<P, Sep>{element, separator};
+}
+
+/** @relates ParMany @brief Syntactic sugar for creating a ParMany parser with a callback. */
+template <class P, class Sep, class F>
+ParMany<P, Sep, F> par_many(const P& element, const Sep& separator, const F& callback,
+                            ThreadPool& pool = ThreadPool::shared()) {
+  return ParMany<P, Sep, F>{element, separator, callback, pool};
+}
+
+}  // namespace tiny_parse
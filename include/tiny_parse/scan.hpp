@@ -0,0 +1,447 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define TINY_PARSE_SSE2 1
+#include <emmintrin.h>
+#else
+#define TINY_PARSE_SSE2 0
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define TINY_PARSE_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define TINY_PARSE_SSSE3 0
+#endif
+
+#if defined(__AVX2__)
+#define TINY_PARSE_AVX2 1
+#include <immintrin.h>
+#else
+#define TINY_PARSE_AVX2 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+#define TINY_PARSE_LITTLE_ENDIAN 1
+#else
+#define TINY_PARSE_LITTLE_ENDIAN 0
+#endif
+
+namespace tiny_parse::detail {
+
+/**
+ * @brief Whether the call happens during constant evaluation.
+ *
+ * Used to keep SIMD and library code, which can't run at compile time, out of constant
+ * expressions. Compilers without the builtin always take the constant evaluation path.
+ */
+constexpr bool is_constant_evaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+  return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+  return __builtin_is_constant_evaluated();
+#else
+  return true;
+#endif
+}
+
+/** @brief The index of the lowest set bit, mask must not be 0. */
+inline unsigned count_trailing_zeros(uint32_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index{};
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/** @brief The index of the lowest set bit, mask must not be 0. */
+inline unsigned count_trailing_zeros(uint64_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index{};
+  _BitScanForward64(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+/** @brief The number of zero bits above the highest set bit, mask must not be 0. */
+inline unsigned count_leading_zeros(uint64_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index{};
+  _BitScanReverse64(&index, mask);
+  return 63U - static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_clzll(mask));
+#endif
+}
+
+/**
+ * @brief A character set as a list of byte ranges, used to pick a SIMD kernel.
+ *
+ * Only sets made up of at most `max_count` ranges are stored, `count` is larger otherwise.
+ */
+struct ByteRanges {
+  static constexpr size_t max_count = 4;
+
+  /** @brief The number of ranges. */
+  size_t count{};
+  /** @brief The lowest byte of each range. */
+  std::array<uint8_t, max_count> lower{};
+  /** @brief The number of bytes in each range, minus one. */
+  std::array<uint8_t, max_count> extent{};
+};
+
+template <class Set>
+constexpr ByteRanges byte_ranges() noexcept {
+  ByteRanges ranges;
+  for (size_t c = 0; c < 256; ++c) {
+    if (!Set::first.contains(static_cast<char>(c))) continue;
+    if (c > 0 && Set::first.contains(static_cast<char>(c - 1))) {
+      if (ranges.count <= ByteRanges::max_count) ++ranges.extent[ranges.count - 1];
+      continue;
+    }
+    if (++ranges.count <= ByteRanges::max_count) {
+      ranges.lower[ranges.count - 1] = static_cast<uint8_t>(c);
+    }
+  }
+  return ranges;
+}
+
+#if TINY_PARSE_SSE2
+/** @brief A bitmask of the bytes in the 16 characters at data that are in the set. */
+template <class Set>
+inline uint32_t match_mask_16(const char* data) noexcept {
+  static constexpr auto ranges = byte_ranges<Set>();
+  const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  auto matches = _mm_setzero_si128();
+  for (size_t r = 0; r < ranges.count; ++r) {
+    // Bytes in [lower, lower + extent] are the ones with (c - lower) <= extent, unsigned.
+    const auto extent = _mm_set1_epi8(static_cast<char>(ranges.extent[r]));
+    const auto offset = _mm_sub_epi8(chars, _mm_set1_epi8(static_cast<char>(ranges.lower[r])));
+    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_mm_min_epu8(offset, extent), offset));
+  }
+  return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+}
+#endif
+
+#if TINY_PARSE_SSSE3 || TINY_PARSE_AVX2
+/**
+ * @brief The nibble lookup tables for matching an arbitrary set with `pshufb`.
+ *
+ * Entry `lo` of `rows[h / 8]` has bit `h % 8` set if the byte `16 * h + lo` is in the set.
+ */
+struct NibbleTables {
+  std::array<std::array<uint8_t, 16>, 2> rows{};
+};
+
+template <class Set>
+constexpr NibbleTables nibble_tables() noexcept {
+  NibbleTables tables;
+  for (size_t c = 0; c < 256; ++c) {
+    if (!Set::first.contains(static_cast<char>(c))) continue;
+    const auto high = c >> 4U;
+    tables.rows[high / 8][c & 0xFU] |= static_cast<uint8_t>(1U << (high % 8));
+  }
+  return tables;
+}
+#endif
+
+#if TINY_PARSE_SSSE3
+template <class Set>
+inline uint32_t lookup_mask_16(const char* data) noexcept {
+  static constexpr auto tables = nibble_tables<Set>();
+  const auto rows_low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.rows[0].data()));
+  const auto rows_high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.rows[1].data()));
+  const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+  const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  const auto low = _mm_and_si128(chars, _mm_set1_epi8(0x0F));
+  const auto high = _mm_and_si128(_mm_srli_epi16(chars, 4), _mm_set1_epi8(0x0F));
+  const auto is_high = _mm_cmpgt_epi8(high, _mm_set1_epi8(7));
+  const auto row = _mm_or_si128(_mm_andnot_si128(is_high, _mm_shuffle_epi8(rows_low, low)),
+                                _mm_and_si128(is_high, _mm_shuffle_epi8(rows_high, low)));
+  const auto bit = _mm_shuffle_epi8(bits, high);
+  const auto misses = _mm_cmpeq_epi8(_mm_and_si128(row, bit), _mm_setzero_si128());
+  return ~static_cast<uint32_t>(_mm_movemask_epi8(misses)) & 0xFFFFU;
+}
+#endif
+
+#if TINY_PARSE_AVX2
+template <class Set>
+inline uint32_t match_mask_32(const char* data) noexcept {
+  static constexpr auto ranges = byte_ranges<Set>();
+  static constexpr auto tables = nibble_tables<Set>();
+  const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+
+  if constexpr (ranges.count <= ByteRanges::max_count) {
+    auto matches = _mm256_setzero_si256();
+    for (size_t r = 0; r < ranges.count; ++r) {
+      const auto extent = _mm256_set1_epi8(static_cast<char>(ranges.extent[r]));
+      const auto offset =
+          _mm256_sub_epi8(chars, _mm256_set1_epi8(static_cast<char>(ranges.lower[r])));
+      matches =
+          _mm256_or_si256(matches, _mm256_cmpeq_epi8(_mm256_min_epu8(offset, extent), offset));
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+  } else {
+    const auto rows_low = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.rows[0].data())));
+    const auto rows_high = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.rows[1].data())));
+    const auto bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                       1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+    const auto low = _mm256_and_si256(chars, _mm256_set1_epi8(0x0F));
+    const auto high = _mm256_and_si256(_mm256_srli_epi16(chars, 4), _mm256_set1_epi8(0x0F));
+    const auto is_high = _mm256_cmpgt_epi8(high, _mm256_set1_epi8(7));
+    const auto row = _mm256_blendv_epi8(_mm256_shuffle_epi8(rows_low, low),
+                                        _mm256_shuffle_epi8(rows_high, low), is_high);
+    const auto bit = _mm256_shuffle_epi8(bits, high);
+    const auto misses = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), _mm256_setzero_si256());
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(misses));
+  }
+}
+#endif
+
+/**
+ * @brief The length of the run of characters in the set of Set at the start of the input.
+ *
+ * Scans 16 or 32 characters at a time with SSE2, SSSE3 or AVX2, depending on what the target
+ * supports. Sets of at most four byte ranges only need SSE2, arbitrary sets need SSSE3. Everything
+ * else, including constant evaluation, falls back to one table lookup per character.
+ *
+ * @tparam Set A type with a `first` CharSet, usually a character class parser.
+ */
+template <class Set>
+constexpr size_t span(const std::string_view& sv) noexcept {
+  size_t i = 0;
+
+  // Inputs shorter than a vector go straight to the scalar loop.
+  if (!is_constant_evaluated() && sv.size() >= 16) {
+    [[maybe_unused]] const auto* data = sv.data();
+    [[maybe_unused]] const auto size = sv.size();
+    [[maybe_unused]] constexpr auto ranges = byte_ranges<Set>();
+
+#if TINY_PARSE_AVX2
+    for (; i + 32 <= size; i += 32) {
+      if (const auto mask = ~match_mask_32<Set>(data + i); mask != 0) {
+        return i + count_trailing_zeros(mask);
+      }
+    }
+#endif
+
+#if TINY_PARSE_SSE2
+    constexpr bool use_sse = TINY_PARSE_SSSE3 || ranges.count <= ByteRanges::max_count;
+    if constexpr (use_sse) {
+      for (; i + 16 <= size; i += 16) {
+        uint32_t mask{};
+        if constexpr (ranges.count <= ByteRanges::max_count) {
+          mask = ~match_mask_16<Set>(data + i) & 0xFFFFU;
+        } else {
+#if TINY_PARSE_SSSE3
+          mask = ~lookup_mask_16<Set>(data + i) & 0xFFFFU;
+#endif
+        }
+        if (mask != 0) return i + count_trailing_zeros(mask);
+      }
+    }
+#endif
+  }
+
+  while (i < sv.size() && Set::first.contains(sv[i])) ++i;
+  return i;
+}
+
+/** @brief The complement of the character set of Set, for searching with span. */
+template <class Set>
+struct Complement {
+  static constexpr auto first = ~Set::first;
+};
+
+/** @brief The only character in the set of Set, or -1 if it doesn't have exactly one. */
+template <class Set>
+constexpr int single_byte() noexcept {
+  int byte = -1;
+  for (int c = 0; c < 256; ++c) {
+    if (!Set::first.contains(static_cast<char>(c))) continue;
+    if (byte != -1) return -1;
+    byte = c;
+  }
+  return byte;
+}
+
+/**
+ * @brief The position of the first character in the set of Set, or the size of the input if none.
+ *
+ * Sets of a single character are searched with memchr, all others with the kernels of span.
+ */
+template <class Set>
+constexpr size_t find_first(const std::string_view& sv) noexcept {
+  if constexpr (constexpr auto byte = single_byte<Set>(); byte != -1) {
+    if (!is_constant_evaluated() && !sv.empty()) {
+      const auto* found = std::memchr(sv.data(), byte, sv.size());
+      return found == nullptr ? sv.size()
+                              : static_cast<size_t>(static_cast<const char*>(found) - sv.data());
+    }
+  }
+  return span<Complement<Set>>(sv);
+}
+
+/**
+ * @brief The position of the first occurrence of the needle at or after `from`, or npos if none.
+ *
+ * Compares the first and the last character of the needle at 16 or 32 positions at once with SSE2
+ * or AVX2, and only compares the rest of the needle at the positions where both match. Falls back
+ * to std::string_view::find for the tail of the input and during constant evaluation.
+ */
+constexpr size_t find_substring(const std::string_view& sv, const std::string_view& needle,
+                                size_t from) noexcept {
+  if (from > sv.size() || sv.size() - from < needle.size()) return std::string_view::npos;
+  if (needle.empty()) return from;
+
+  size_t i = from;
+  if (!is_constant_evaluated()) {
+    [[maybe_unused]] const auto* data = sv.data();
+    [[maybe_unused]] const auto n = needle.size();
+    // The last block must end before the last character of the input when shifted by n - 1.
+    [[maybe_unused]] const auto end = sv.size() - n + 1;
+    [[maybe_unused]] const auto matches_rest = [&](size_t position) {
+      return n <= 2 || std::memcmp(data + position + 1, needle.data() + 1, n - 2) == 0;
+    };
+
+#if TINY_PARSE_AVX2
+    const auto first_32 = _mm256_set1_epi8(needle.front());
+    const auto last_32 = _mm256_set1_epi8(needle.back());
+    for (; i + 32 <= end; i += 32) {
+      const auto firsts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+      const auto lasts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + n - 1));
+      auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(
+          _mm256_cmpeq_epi8(firsts, first_32), _mm256_cmpeq_epi8(lasts, last_32))));
+      for (; mask != 0; mask &= mask - 1) {
+        const auto position = i + count_trailing_zeros(mask);
+        if (matches_rest(position)) return position;
+      }
+    }
+#endif
+
+#if TINY_PARSE_SSE2
+    const auto first_16 = _mm_set1_epi8(needle.front());
+    const auto last_16 = _mm_set1_epi8(needle.back());
+    for (; i + 16 <= end; i += 16) {
+      const auto firsts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      const auto lasts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + n - 1));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(firsts, first_16), _mm_cmpeq_epi8(lasts, last_16))));
+      for (; mask != 0; mask &= mask - 1) {
+        const auto position = i + count_trailing_zeros(mask);
+        if (matches_rest(position)) return position;
+      }
+    }
+#endif
+  }
+
+  return sv.find(needle, i);
+}
+
+/**
+ * @brief The position of the first of either of two characters at or after `from`, or npos.
+ *
+ * Compares 16 or 32 characters at once with SSE2 or AVX2, like memchr does for one character.
+ */
+inline size_t find_either(const std::string_view& sv, char a, char b, size_t from) noexcept {
+  size_t i = from;
+  [[maybe_unused]] const auto* data = sv.data();
+
+#if TINY_PARSE_AVX2
+  const auto a_32 = _mm256_set1_epi8(a);
+  const auto b_32 = _mm256_set1_epi8(b);
+  for (; i + 32 <= sv.size(); i += 32) {
+    const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chars, a_32), _mm256_cmpeq_epi8(chars, b_32))));
+    if (mask != 0) return i + count_trailing_zeros(mask);
+  }
+#endif
+
+#if TINY_PARSE_SSE2
+  const auto a_16 = _mm_set1_epi8(a);
+  const auto b_16 = _mm_set1_epi8(b);
+  for (; i + 16 <= sv.size(); i += 16) {
+    const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const auto mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars, a_16), _mm_cmpeq_epi8(chars, b_16))));
+    if (mask != 0) return i + count_trailing_zeros(mask);
+  }
+#endif
+
+  for (; i < sv.size(); ++i) {
+    if (sv[i] == a || sv[i] == b) return i;
+  }
+  return std::string_view::npos;
+}
+
+/** @brief The unsigned integer type used to compare literals of N characters. */
+template <size_t N>
+using literal_word_t =
+    std::conditional_t<(N < 4), uint16_t, std::conditional_t<(N < 8), uint32_t, uint64_t>>;
+
+/** @brief The little-endian word of the characters starting at offset, as loaded from memory. */
+template <class Word, size_t N>
+constexpr Word pack_literal(const std::array<char, N>& chars, size_t offset) noexcept {
+  Word word{};
+  for (size_t i = 0; i < sizeof(Word); ++i) {
+    word |= static_cast<Word>(static_cast<Word>(static_cast<unsigned char>(chars[offset + i]))
+                              << (8 * i));
+  }
+  return word;
+}
+
+/**
+ * @brief Whether the input starts with the characters Cs, the input must be at least as long.
+ *
+ * Literals of up to 16 characters are compared with two overlapping loads of the largest word
+ * that fits, longer ones with memcmp.
+ */
+template <char... Cs>
+constexpr bool starts_with(const char* data) noexcept {
+  constexpr size_t n = sizeof...(Cs);
+  constexpr std::array<char, n> chars{Cs...};
+
+  if (is_constant_evaluated()) {
+    for (size_t i = 0; i < n; ++i) {
+      if (data[i] != chars[i]) return false;
+    }
+    return true;
+  }
+
+  if constexpr (n == 1) {
+    return data[0] == chars[0];
+  } else if constexpr (TINY_PARSE_LITTLE_ENDIAN && n <= 16) {
+    using Word = literal_word_t<n>;
+    constexpr auto head = pack_literal<Word>(chars, 0);
+    constexpr auto tail = pack_literal<Word>(chars, n - sizeof(Word));
+    Word first{};
+    Word last{};
+    std::memcpy(&first, data, sizeof(Word));
+    std::memcpy(&last, data + n - sizeof(Word), sizeof(Word));
+    return ((first ^ head) | (last ^ tail)) == 0;
+  } else {
+    return std::memcmp(data, chars.data(), n) == 0;
+  }
+}
+
+}  // namespace tiny_parse::detail
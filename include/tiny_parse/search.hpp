@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "scan.hpp"
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+namespace detail {
+
+/**
+ * @brief The first offset at or after `from` at which the parser could match.
+ *
+ * Parsers that can't match the empty string can only start with a character of their FIRST set,
+ * so the offsets in between are skipped with find_first. Returns the size of the input if there is
+ * no such offset.
+ */
+template <class T>
+constexpr size_t next_start(const std::string_view& sv, size_t from) noexcept {
+  if constexpr (T::nullable || T::first == CharSet::all()) {
+    return from;
+  } else {
+    return from + find_first<T>(sv.substr(from));
+  }
+}
+
+/**
+ * @brief Finds the offsets of an input at which a parser could match, in increasing order.
+ *
+ * If every match of the parser contains a required literal (see RequiredLiteral) of at least two
+ * characters, the input is first searched for the literal, and only the offsets from which the
+ * literal is within reach are considered. A match starting at `s` contains the literal at some
+ * position in `[s + min_offset, s + max_offset]`, so it is covered by the first occurrence at or
+ * after `s + min_offset`. Within these windows, and everywhere otherwise, offsets are skipped
+ * by their first character, see next_start.
+ */
+template <class T>
+class Candidates {
+ public:
+  constexpr explicit Candidates(const std::string_view& sv) noexcept : sv_{sv} {}
+
+  /** @brief The first candidate offset at or after `from`, or npos if there is none. */
+  constexpr size_t next(size_t from) noexcept {
+    if (from > sv_.size()) return std::string_view::npos;
+    if constexpr (!use_literal) {
+      return next_start<T>(sv_, from);
+    } else {
+      while (true) {
+        if (window_end_ != std::string_view::npos && from <= window_end_) {
+          // Keep the first character scan within the window, the next one may be far away.
+          const auto start = next_start<T>(sv_.substr(0, window_end_ + 1), from);
+          if (start <= window_end_) return start;
+          from = window_end_ + 1;
+        }
+
+        const auto hit = find_substring(sv_, literal.view(), from + literal.min_offset);
+        if (hit == std::string_view::npos) return hit;
+
+        window_end_ = hit - literal.min_offset;
+        if (literal.max_offset != unbounded && hit >= literal.max_offset) {
+          from = std::max(from, hit - literal.max_offset);
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr RequiredLiteral literal = T::required;
+  static constexpr bool use_literal = literal.size >= 2;
+
+  std::string_view sv_;
+  /** @brief The last offset covered by the latest occurrence of the literal. */
+  size_t window_end_{std::string_view::npos};
+};
+
+}  // namespace detail
+
+/**
+ * @brief Invoke a callback for every match of a parser in the input.
+ *
+ * Unlike BaseParser::parse, the match may start anywhere in the input. Matches don't overlap: the
+ * search continues after the end of each match, or one character after an empty one.
+ *
+ * The parser is only run at offsets where it could match, judging by its first set and its
+ * required literal, see RequiredLiteral.
+ *
+ * @param callback Invoked with the part of the input consumed by each match.
+ */
+template <class T, class Callback>
+constexpr void for_each_match(const std::string_view& sv, const BaseParser<T>& parser,
+                              Callback&& callback) {
+  const auto min_length = std::max(static_cast<const T&>(parser).min_length(), T::min_width);
+  detail::Candidates<T> candidates{sv};
+  for (auto i = candidates.next(0); i != std::string_view::npos && sv.size() - i >= min_length;) {
+    // Candidate offsets are within the input, which substr would check again.
+    const std::string_view rest{sv.data() + i, sv.size() - i};
+    const auto result = parser.parse(rest);
+    if (!result) {
+      i = candidates.next(i + 1);
+      continue;
+    }
+
+    const auto length = rest.size() - result.value.size();
+    callback(rest.substr(0, length));
+    i = candidates.next(i + std::max<size_t>(length, 1));
+  }
+}
+
+/**
+ * @brief Find the first match of a parser in the input.
+ *
+ * @see for_each_match
+ * @return std::optional<std::string_view> The part of the input consumed by the match, or nothing
+ * if the parser doesn't match anywhere.
+ */
+template <class T>
+constexpr std::optional<std::string_view> find(const std::string_view& sv,
+                                               const BaseParser<T>& parser) {
+  const auto min_length = std::max(static_cast<const T&>(parser).min_length(), T::min_width);
+  detail::Candidates<T> candidates{sv};
+  for (auto i = candidates.next(0); i != std::string_view::npos && sv.size() - i >= min_length;
+       i = candidates.next(i + 1)) {
+    const auto rest = sv.substr(i);
+    if (const auto result = parser.parse(rest); result) {
+      return rest.substr(0, rest.size() - result.value.size());
+    }
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Find all non-overlapping matches of a parser in the input.
+ *
+ * @see for_each_match
+ */
+template <class T>
+std::vector<std::string_view> find_all(const std::string_view& sv, const BaseParser<T>& parser) {
+  std::vector<std::string_view> matches;
+  for_each_match(sv, parser, [&](std::string_view match) { matches.push_back(match); });
+  return matches;
+}
+
+}  // namespace tiny_parse
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+/** @brief The state of a StreamParser after it was fed input. */
+enum class StreamStatus {
+  /** @brief All complete records were parsed, the rest waits for the next chunk. */
+  need_more_input,
+  /** @brief The stream was finished and all of it was parsed. */
+  done,
+  /** @brief A record failed to parse, see StreamParser::consumed for where. */
+  error,
+};
+
+/**
+ * @brief Parses a stream of records that arrives in chunks.
+ *
+ * Records are parsed in place in the chunks they arrive in and passed to a callback. Only a record
+ * that is cut by the end of a chunk is carried over to the next one: the parse is resumed at the
+ * start of that record, with just enough of the next chunk appended to it to complete it. Chunks
+ * are never concatenated as a whole.
+ *
+ * A record parse is incomplete if any parser in it looked at the end of the chunk, e.g. a
+ * repetition that ran into it, a literal that was cut short or a sequence with fewer characters
+ * left than its min_width, see detail::reached_end. An error in a record shorter than that is
+ * only reported once more input arrives, or by finish. The record parser has to consume at least
+ * one character, and actions inside it may also run for the incomplete parse of a cut record, like
+ * they do for alternatives that fail later. Use the callback for side effects that should only
+ * happen once per record.
+ *
+ * @tparam T The parser for a single record.
+ * @tparam Callback Invoked with the input of each parsed record. The view points into either the
+ * chunk being fed or the buffer for a cut record, so it is only valid during the call. Copy the
+ * record to keep it past the next call to feed or finish.
+ */
+template <class T, class Callback>
+class StreamParser {
+ public:
+  StreamParser(const T& record, const Callback& callback) : record_{record}, callback_{callback} {}
+
+  /**
+   * @brief Parse the complete records in the next chunk of the stream.
+   *
+   * The chunk doesn't have to outlive the call.
+   *
+   * @return StreamStatus need_more_input, or error if a record failed to parse.
+   */
+  StreamStatus feed(std::string_view chunk) {
+    if (status_ != StreamStatus::need_more_input) return status_;
+
+    // Append growing parts of the chunk to the cut record, until the records in the carried input
+    // are complete and the rest can be parsed in place.
+    size_t taken = 0;
+    auto step = std::max(carry_.size(), min_step);
+    while (!carry_.empty()) {
+      const auto length = parse_record(carry_, false);
+      if (status_ == StreamStatus::error) return status_;
+      if (length == incomplete) {
+        if (taken == chunk.size()) return status_;
+        const auto n = std::min(step, chunk.size() - taken);
+        carry_.append(chunk.data() + taken, n);
+        taken += n;
+        step *= 2;
+        continue;
+      }
+
+      carry_.erase(0, length);
+      if (carry_.size() <= taken) {
+        chunk.remove_prefix(taken - carry_.size());
+        carry_.clear();
+      }
+    }
+
+    while (!chunk.empty()) {
+      const auto length = parse_record(chunk, false);
+      if (status_ == StreamStatus::error) return status_;
+      if (length == incomplete) {
+        carry_.assign(chunk);
+        return status_;
+      }
+      chunk.remove_prefix(length);
+    }
+    return status_;
+  }
+
+  /**
+   * @brief Signal the end of the stream and parse the records that are left.
+   *
+   * @return StreamStatus done, or error if a record failed to parse.
+   */
+  StreamStatus finish() {
+    if (status_ != StreamStatus::need_more_input) return status_;
+
+    std::string_view rest = carry_;
+    while (!rest.empty() && status_ != StreamStatus::error) {
+      rest.remove_prefix(parse_record(rest, true));
+    }
+    carry_.clear();
+    if (status_ != StreamStatus::error) status_ = StreamStatus::done;
+    return status_;
+  }
+
+  /** @brief The number of characters of the stream in the records parsed so far. */
+  [[nodiscard]] size_t consumed() const noexcept { return consumed_; }
+
+  /** @brief The number of characters of a cut record, held until the next chunk completes it. */
+  [[nodiscard]] size_t buffered() const noexcept { return carry_.size(); }
+
+ private:
+  static constexpr size_t incomplete = std::string_view::npos;
+  static constexpr size_t min_step = 64;
+
+  /**
+   * @brief Parse a record at the start of the input.
+   *
+   * @return size_t The length of the record, or incomplete if more input could change the parse
+   * and the input isn't final. Sets the status to error if the record fails to parse.
+   */
+  size_t parse_record(std::string_view sv, bool final) {
+    detail::reached_end = false;
+    const auto result = record_.parse(sv);
+    if (!final && detail::reached_end) return incomplete;
+
+    const auto length = sv.size() - result.value.size();
+    if (!result || length == 0) {
+      status_ = StreamStatus::error;
+      return 0;
+    }
+
+    callback_(sv.substr(0, length));
+    consumed_ += length;
+    return length;
+  }
+
+  T record_;
+  Callback callback_;
+  /** @brief The start of a record cut by the end of the previous chunk. */
+  std::string carry_;
+  size_t consumed_{0};
+  StreamStatus status_{StreamStatus::need_more_input};
+};
+
+}  // namespace tiny_parse
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "tiny_parse.hpp"
+
+namespace tiny_parse {
+
+/**
+ * @brief A parser that matches the longest of a set of keywords and produces its value.
+ *
+ * The keywords are stored in a packed trie: the children of the root are found through a table
+ * indexed by the first character, the children of deeper nodes through sorted arrays of edge
+ * characters. Parsing walks the trie once and doesn't allocate.
+ *
+ * An action attached to this parser is invoked with the value of the matched keyword, unless it
+ * accepts the matched string.
+ *
+ * @tparam Value The value associated with each keyword.
+ */
+template <class Value>
+class Symbols : public BaseParser<Symbols<Value>> {
+ public:
+  using attribute_type = Value;
+
+  static constexpr bool nullable = false;
+  static constexpr size_t min_width = 1;
+
+  /**
+   * @brief Construct the parser from (keyword, value) pairs.
+   *
+   * @throws std::invalid_argument if a keyword is empty or appears more than once.
+   */
+  Symbols(std::initializer_list<std::pair<std::string_view, Value>> symbols)
+      : Symbols(symbols.begin(), symbols.end()) {}
+
+  /**
+   * @brief Construct the parser from a range of (keyword, value) pairs.
+   *
+   * @throws std::invalid_argument if a keyword is empty or appears more than once.
+   */
+  template <class It>
+  Symbols(It begin, It end) {
+    std::vector<std::map<unsigned char, uint32_t>> children(1);
+    values_of_nodes_.push_back(no_value);
+
+    for (auto it = begin; it != end; ++it) {
+      const std::string_view keyword = it->first;
+      if (keyword.empty()) throw std::invalid_argument{"Symbols can't match an empty keyword"};
+
+      uint32_t node = 0;
+      for (const auto c : keyword) {
+        const auto [child, inserted] = children[node].try_emplace(
+            static_cast<unsigned char>(c), static_cast<uint32_t>(children.size()));
+        if (inserted) {
+          children.emplace_back();
+          values_of_nodes_.push_back(no_value);
+        }
+        node = child->second;
+      }
+
+      if (values_of_nodes_[node] != no_value) {
+        throw std::invalid_argument{"Duplicate keyword \"" + std::string{keyword} + "\""};
+      }
+      values_of_nodes_[node] = static_cast<uint32_t>(values_.size());
+      values_.push_back(it->second);
+      min_length_ = std::min(min_length_, keyword.size());
+    }
+
+    root_.fill(no_node);
+    for (const auto& [c, child] : children[0]) root_[c] = child;
+
+    edges_begin_.reserve(children.size() + 1);
+    for (const auto& edges : children) {
+      edges_begin_.push_back(static_cast<uint32_t>(edge_chars_.size()));
+      for (const auto& [c, child] : edges) {
+        edge_chars_.push_back(c);
+        edge_targets_.push_back(child);
+      }
+    }
+    edges_begin_.push_back(static_cast<uint32_t>(edge_chars_.size()));
+  }
+
+  /** @brief The length of the shortest keyword. */
+  [[nodiscard]] size_t min_length() const noexcept { return values_.empty() ? 0 : min_length_; }
+
+ protected:
+  friend class BaseParser<Symbols>;
+
+  [[nodiscard]] Result parse_it(const std::string_view& sv) const {
+    const auto [length, value] = longest_match(sv);
+    return value == no_value ? Result{sv, false} : Result{sv.substr(length), true};
+  }
+
+  [[nodiscard]] Result parse_it(const std::string_view& sv, Value& attribute) const {
+    const auto [length, value] = longest_match(sv);
+    if (value == no_value) return {sv, false};
+
+    attribute = values_[value];
+    return {sv.substr(length), true};
+  }
+
+ private:
+  static constexpr uint32_t no_node = 0;
+  static constexpr uint32_t no_value = std::numeric_limits<uint32_t>::max();
+
+  /** @brief The length and value index of the longest keyword at the start of the input. */
+  [[nodiscard]] std::pair<size_t, uint32_t> longest_match(const std::string_view& sv) const {
+    std::pair<size_t, uint32_t> match{0, no_value};
+    if (sv.empty()) {
+      detail::mark_end();
+      return match;
+    }
+
+    auto node = root_[static_cast<unsigned char>(sv.front())];
+    for (size_t i = 1; node != no_node; ++i) {
+      if (values_of_nodes_[node] != no_value) match = {i, values_of_nodes_[node]};
+      if (i == sv.size()) {
+        // A longer keyword may continue past the end of the input.
+        if (edges_begin_[node] != edges_begin_[node + 1]) detail::mark_end();
+        break;
+      }
+      node = child(node, static_cast<unsigned char>(sv[i]));
+    }
+    return match;
+  }
+
+  [[nodiscard]] uint32_t child(uint32_t node, unsigned char c) const noexcept {
+    const auto* begin = edge_chars_.data() + edges_begin_[node];
+    const auto* end = edge_chars_.data() + edges_begin_[node + 1];
+
+    const auto* edge =
+        end - begin <= 8 ? std::find(begin, end, c) : std::lower_bound(begin, end, c);
+    if (edge == end || *edge != c) return no_node;
+    return edge_targets_[static_cast<size_t>(edge - edge_chars_.data())];
+  }
+
+  /** @brief The child of the root for each first character. */
+  std::array<uint32_t, 256> root_{};
+  /** @brief The start of the edges of each node, followed by the total number of edges. */
+  std::vector<uint32_t> edges_begin_;
+  /** @brief The characters of the edges, sorted per node. */
+  std::vector<unsigned char> edge_chars_;
+  /** @brief The child nodes of the edges. */
+  std::vector<uint32_t> edge_targets_;
+  /** @brief The index into values_ for each node, or no_value if no keyword ends there. */
+  std::vector<uint32_t> values_of_nodes_;
+  std::vector<Value> values_;
+  size_t min_length_{std::numeric_limits<size_t>::max()};
+};
+
+}  // namespace tiny_parse
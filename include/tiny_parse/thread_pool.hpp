@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tiny_parse {
+
+/**
+ * @brief A work-stealing thread pool for running the parallel parsers.
+ *
+ * Every worker has its own task queue. A batch of tasks is spread over the queues, workers take
+ * tasks from the front of their own queue and steal from the back of the others' when it runs dry.
+ * The thread that submits a batch works on it as well until it is done, so batches can be nested:
+ * a task can submit and wait for a batch of its own without tying up a worker.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Construct a pool.
+   *
+   * @param workers The number of worker threads. The submitting thread works as well, so by
+   * default there is one worker less than there are hardware threads.
+   */
+  explicit ThreadPool(size_t workers = default_workers()) {
+    for (size_t i = 0; i <= workers; ++i) queues_.push_back(std::make_unique<Queue>());
+    threads_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) threads_.emplace_back([this, i] { work(i); });
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      const std::lock_guard lock{mutex_};
+      stop_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& thread : threads_) thread.join();
+  }
+
+  /** @brief A pool shared by all parallel parsers that aren't given one. */
+  static ThreadPool& shared() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  /** @brief The number of threads that run tasks, including the submitting thread. */
+  [[nodiscard]] size_t concurrency() const noexcept { return threads_.size() + 1; }
+
+  /**
+   * @brief Invoke `task(i)` for every i in [0, count) and wait for all of them.
+   *
+   * The tasks run concurrently and in no particular order. If any of them throws, the first
+   * exception is rethrown once all of them are done.
+   */
+  template <class F>
+  void parallel_for(size_t count, F&& task) {
+    if (count == 0) return;
+
+    using Function = std::remove_reference_t<F>;
+    Batch batch{const_cast<void*>(static_cast<const void*>(&task)),
+                [](void* f, size_t i) { (*static_cast<Function*>(f))(i); }, count};
+    const auto own = own_queue();
+    for (size_t i = 0; i < count; ++i) {
+      auto& queue = *queues_[(own + i) % queues_.size()];
+      const std::lock_guard lock{queue.mutex};
+      queue.tasks.push_back({&batch, i});
+    }
+    {
+      const std::lock_guard lock{mutex_};
+      pending_ += count;
+    }
+    work_available_.notify_all();
+
+    // Help with the batch, and whatever else is queued, until it is done.
+    while (batch.remaining.load(std::memory_order_acquire) != 0) {
+      if (auto task = take(own); task.batch != nullptr) {
+        run(task);
+        continue;
+      }
+      std::unique_lock lock{mutex_};
+      batch_done_.wait(lock, [&] {
+        return batch.remaining.load(std::memory_order_acquire) == 0 || pending_ != 0;
+      });
+    }
+
+    if (batch.exception) std::rethrow_exception(batch.exception);
+  }
+
+ private:
+  struct Batch {
+    void* function;
+    void (*invoke)(void*, size_t);
+    std::atomic<size_t> remaining;
+    std::mutex mutex{};
+    std::exception_ptr exception{};
+  };
+
+  struct Task {
+    Batch* batch;
+    size_t index;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  static size_t default_workers() noexcept {
+    const auto threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 0;
+  }
+
+  /** @brief The queue of the current thread: its own for workers, the last one for others. */
+  size_t own_queue() const noexcept {
+    return current_pool == this ? current_queue : queues_.size() - 1;
+  }
+
+  /** @brief Take a task from the front of the own queue, or steal one from the back of another. */
+  Task take(size_t own) {
+    for (size_t i = 0; i < queues_.size(); ++i) {
+      auto& queue = *queues_[(own + i) % queues_.size()];
+      const std::lock_guard lock{queue.mutex};
+      if (queue.tasks.empty()) continue;
+
+      Task task{};
+      if (i == 0) {
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+      } else {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+      }
+      const std::lock_guard pending_lock{mutex_};
+      --pending_;
+      return task;
+    }
+    return {};
+  }
+
+  void run(const Task& task) {
+    auto& batch = *task.batch;
+    try {
+      batch.invoke(batch.function, task.index);
+    } catch (...) {
+      const std::lock_guard lock{batch.mutex};
+      if (!batch.exception) batch.exception = std::current_exception();
+    }
+
+    if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // The submitter may destroy the batch as soon as it sees it done, so it isn't touched here.
+      const std::lock_guard lock{mutex_};
+      batch_done_.notify_all();
+    }
+  }
+
+  void work(size_t queue) {
+    current_pool = this;
+    current_queue = queue;
+    while (true) {
+      if (auto task = take(queue); task.batch != nullptr) {
+        run(task);
+        continue;
+      }
+      std::unique_lock lock{mutex_};
+      work_available_.wait(lock, [&] { return stop_ || pending_ != 0; });
+      if (stop_) return;
+    }
+  }
+
+  static inline thread_local const ThreadPool* current_pool = nullptr;
+  static inline thread_local size_t current_queue = 0;
+
+  /** @brief One queue per worker, and a last one shared by the threads outside the pool. */
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  /** @brief Signalled when tasks are queued or the pool stops. */
+  std::condition_variable work_available_;
+  /** @brief Signalled when a batch is done. */
+  std::condition_variable batch_done_;
+  /** @brief The number of queued tasks that weren't taken yet. */
+  size_t pending_{0};
+  bool stop_{false};
+};
+
+}  // namespace tiny_parse
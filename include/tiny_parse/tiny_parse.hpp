@@ -1,10 +1,22 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <iomanip>
+#include <limits>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "scan.hpp"
 
 namespace tiny_parse {
 
@@ -30,8 +42,8 @@ struct Result {
    * @return true if the parse was successful.
    * @return false if the parse was not successful.
    */
-  explicit operator bool() const noexcept { return success; }
-  bool operator==(const Result& other) const noexcept {
+  constexpr explicit operator bool() const noexcept { return success; }
+  constexpr bool operator==(const Result& other) const noexcept {
     return value == other.value && success == other.success;
   }
   friend std::ostream& operator<<(std::ostream& os, const Result& result);
@@ -45,27 +57,295 @@ inline std::ostream& operator<<(std::ostream& os, const Result& result) {
             << (result.success ? "true"sv : "false"sv) << "}"sv;
 }
 
+/**
+ * @brief A set of characters, stored as a 256-bit mask indexed by the byte value.
+ */
+class CharSet {
+ public:
+  constexpr CharSet() noexcept = default;
+
+  /** @brief The set of all characters. */
+  static constexpr CharSet all() noexcept { return ~CharSet{}; }
+
+  /** @brief The set with the given 64-bit words of the mask, see word(). */
+  static constexpr CharSet from_words(uint64_t w0, uint64_t w1, uint64_t w2, uint64_t w3) noexcept {
+    CharSet set;
+    set.words_[0] = w0;
+    set.words_[1] = w1;
+    set.words_[2] = w2;
+    set.words_[3] = w3;
+    return set;
+  }
+
+  /** @brief The set containing only the given character. */
+  static constexpr CharSet single(char c) noexcept {
+    CharSet set;
+    set.insert(c);
+    return set;
+  }
+
+  /** @brief The set of characters in the range [lower, upper]. */
+  static constexpr CharSet range(char lower, char upper) noexcept {
+    CharSet set;
+    for (int c = lower; c <= upper; ++c) set.insert(static_cast<char>(c));
+    return set;
+  }
+
+  /** @brief Add a character to the set. */
+  constexpr CharSet& insert(char c) noexcept {
+    const auto byte = static_cast<unsigned char>(c);
+    words_[byte / 64U] |= uint64_t{1} << (byte % 64U);
+    return *this;
+  }
+
+  /** @brief Whether the set contains the given character. */
+  [[nodiscard]] constexpr bool contains(char c) const noexcept {
+    const auto byte = static_cast<unsigned char>(c);
+    return ((words_[byte / 64U] >> (byte % 64U)) & 1U) != 0;
+  }
+
+  /** @brief The i-th 64-bit word of the mask, for bytes [64 * i, 64 * i + 63]. */
+  [[nodiscard]] constexpr uint64_t word(size_t i) const noexcept { return words_[i]; }
+
+  /** @brief Whether the set contains no characters. */
+  [[nodiscard]] constexpr bool empty() const noexcept {
+    return (words_[0] | words_[1] | words_[2] | words_[3]) == 0;
+  }
+
+  /** @brief The union of two sets. */
+  constexpr CharSet operator|(const CharSet& other) const noexcept {
+    CharSet set;
+    for (size_t i = 0; i < 4; ++i) set.words_[i] = words_[i] | other.words_[i];
+    return set;
+  }
+
+  /** @brief The intersection of two sets. */
+  constexpr CharSet operator&(const CharSet& other) const noexcept {
+    CharSet set;
+    for (size_t i = 0; i < 4; ++i) set.words_[i] = words_[i] & other.words_[i];
+    return set;
+  }
+
+  /** @brief The complement of this set. */
+  constexpr CharSet operator~() const noexcept {
+    CharSet set;
+    for (size_t i = 0; i < 4; ++i) set.words_[i] = ~words_[i];
+    return set;
+  }
+
+  constexpr bool operator==(const CharSet& other) const noexcept {
+    for (size_t i = 0; i < 4; ++i) {
+      if (words_[i] != other.words_[i]) return false;
+    }
+    return true;
+  }
+
+  constexpr bool operator!=(const CharSet& other) const noexcept { return !(*this == other); }
+
+ private:
+  uint64_t words_[4]{};
+};
+
+/** @brief The maximum width of a parser that can consume any number of characters. */
+inline constexpr size_t unbounded = std::numeric_limits<size_t>::max();
+
+/** @brief The count of a Times parser that is only known at run time. */
+inline constexpr size_t dynamic_count = std::numeric_limits<size_t>::max();
+
+namespace detail {
+
+/** @brief The sum of two widths, saturating at unbounded. */
+constexpr size_t add_widths(size_t lhs, size_t rhs) noexcept {
+  return lhs > unbounded - rhs ? unbounded : lhs + rhs;
+}
+
+/**
+ * @brief Whether a parser looked at the end of its input since this was last reset.
+ *
+ * Parsers that fail or stop because their input ended set this, so that a StreamParser can tell a
+ * parse that might have gone differently with more input from a final one.
+ */
+inline thread_local bool reached_end = false;
+
+/** @brief Record that a parser looked at the end of its input, see reached_end. */
+constexpr void mark_end() noexcept {
+  if (!is_constant_evaluated()) reached_end = true;
+}
+
+/**
+ * @brief Whether the input is shorter than the given minimum width of a match.
+ *
+ * Parsers reject such inputs up front, and mark the end since more input could complete a match.
+ */
+constexpr bool too_short(const std::string_view& sv, size_t width) noexcept {
+  if (sv.size() >= width) return false;
+  mark_end();
+  return true;
+}
+
+/** @brief The width of count repetitions, saturating at unbounded. */
+constexpr size_t multiply_width(size_t width, size_t count) noexcept {
+  if (width == 0 || count == 0) return 0;
+  return width > unbounded / count ? unbounded : width * count;
+}
+
+/** @brief The count of a Times parser, stored only if it is given at run time. */
+template <size_t N>
+struct Count {
+  [[nodiscard]] static constexpr size_t value() noexcept { return N; }
+};
+
+template <>
+struct Count<dynamic_count> {
+  size_t count;
+
+  [[nodiscard]] constexpr size_t value() const noexcept { return count; }
+};
+
+/** @brief The sum of a list of widths, saturating at unbounded. */
+constexpr size_t sum_widths(std::initializer_list<size_t> widths) noexcept {
+  size_t sum = 0;
+  for (const auto width : widths) sum = add_widths(sum, width);
+  return sum;
+}
+
+}  // namespace detail
+
+/**
+ * @brief A literal that every match of a parser contains.
+ *
+ * Found by analysing the combinator tree, and used by search to only run the parser near the
+ * places where the literal occurs, see find. Literals longer than max_size are cut short.
+ */
+struct RequiredLiteral {
+  static constexpr size_t max_size = 16;
+
+  std::array<char, max_size> chars{};
+  /** @brief The length of the literal, 0 if there is none. */
+  size_t size{};
+  /** @brief The minimum distance of the literal from the start of a match. */
+  size_t min_offset{};
+  /** @brief The maximum distance of the literal from the start of a match, may be unbounded. */
+  size_t max_offset{};
+
+  [[nodiscard]] constexpr std::string_view view() const noexcept { return {chars.data(), size}; }
+
+  /** @brief The same literal, preceded by between min and max characters. */
+  [[nodiscard]] constexpr RequiredLiteral shifted(size_t min, size_t max) const noexcept {
+    return {chars, size, detail::add_widths(min_offset, min), detail::add_widths(max_offset, max)};
+  }
+
+  /** @brief Whether this literal is a better filter than the other: longer, or better placed. */
+  [[nodiscard]] constexpr bool better_than(const RequiredLiteral& other) const noexcept {
+    if (size != other.size) return size > other.size;
+    return max_offset - min_offset < other.max_offset - other.min_offset;
+  }
+};
+
 /**
  * @brief Abstract base class for parsers.
  *
- * This is mainly used to allow for runtime polymorphism, without the need to
- * specify all template parameters.
+ * Parsers built from BaseParser are statically dispatched and do not derive from this class. It is
+ * only used as an opt-in type-erasure boundary, e.g. to hide the concrete type of a grammar behind
+ * a compilation firewall. See Erased and ParserRef.
  */
 class Parser {
  public:
   virtual ~Parser() = default;
 
   [[nodiscard]] virtual Result parse(const std::string_view& sv) const = 0;
+
+  /**
+   * @brief The minimum number of parsed characters that constitute a full
+   * parse
+   */
+  [[nodiscard]] virtual size_t min_length() const noexcept = 0;
 };
 
+/** @brief The attribute of a parser that doesn't produce a value, see attribute_of. */
+struct Unused {
+  constexpr bool operator==(const Unused& /*other*/) const noexcept { return true; }
+};
+
+/**
+ * @brief The type of the value a parser produces, see BaseParser::parse.
+ *
+ * Parsers declare it with an `attribute_type` member type, combinators specialize this trait, so
+ * that the attribute of a combinator is only computed when it is used. Parsers that don't produce a
+ * value have the attribute Unused.
+ */
+template <class T, class = void>
+struct attribute_of {
+  using type = Unused;
+};
+
+template <class T>
+struct attribute_of<T, std::void_t<typename T::attribute_type>> {
+  using type = typename T::attribute_type;
+};
+
+template <class T>
+using attribute_of_t = typename attribute_of<T>::type;
+
+namespace detail {
+
+template <class T>
+inline constexpr bool is_unused_v = std::is_same_v<T, Unused>;
+
+}  // namespace detail
+
+template <class T, class F>
+class Action;
+
 /**
  * @brief The base parser class.
+ *
+ * Uses the CRTP to call the `parse_it` implementation of the derived parser directly, so that
+ * combinator trees are resolved at compile time and can be inlined as a whole. The base class holds
+ * no state, so parsers built from stateless parsers are literal types and can be used in constant
+ * expressions.
+ *
+ * Derived parsers have to provide a `parse_it(const std::string_view&)` function, accessible from
+ * this class, and a `min_length()` function. They should also shadow the `first`, `nullable`,
+ * `provably_nullable`, `min_width`, `max_width` and `required` properties with the tightest values
+ * they can give, which combinators like Or use to skip alternatives that can't match and search
+ * uses to skip input.
  */
 template <class Derived>
-class BaseParser : public Parser {
+class BaseParser {
  public:
-  BaseParser() = default;
-  ~BaseParser() override = default;
+  /**
+   * @brief The set of characters a parse that consumes input can start with.
+   *
+   * A parser that isn't nullable can only succeed if the first character of the input is in this
+   * set.
+   */
+  static constexpr CharSet first = CharSet::all();
+
+  /** @brief Whether a parse can succeed without consuming any input. */
+  static constexpr bool nullable = true;
+
+  /**
+   * @brief Whether a parse is known to succeed without consuming input, for some input.
+   *
+   * Unlike nullable, which is only false if a parser is known to always consume input, this is
+   * only true if it is known not to. A repetition of such a parser would never end, so Many,
+   * GreaterThan and Fold reject them at compile time. Parsers that might be nullable, e.g. a
+   * ParserRef, are guarded at run time instead: the repetition stops at the first element that
+   * consumes nothing, as in PEG engines.
+   */
+  static constexpr bool provably_nullable = false;
+
+  /** @brief The minimum number of characters a successful parse consumes. */
+  static constexpr size_t min_width = 0;
+
+  /** @brief The maximum number of characters a successful parse consumes, may be unbounded. */
+  static constexpr size_t max_width = unbounded;
+
+  /** @brief A literal that every successful parse consumes, if there is one. */
+  static constexpr RequiredLiteral required{};
+
+  constexpr BaseParser() = default;
 
   /**
    * @brief Create a copy of this parser.
@@ -74,129 +354,733 @@ class BaseParser : public Parser {
    *
    * @return Derived A copy of this parser.
    */
-  Derived copy() const noexcept { return Derived{*static_cast<const Derived*>(this)}; }
+  constexpr Derived copy() const noexcept { return Derived{derived()}; }
+
+  /**
+   * @brief Create a parser that invokes an action on the parsed string.
+   *
+   * @param action The action to invoke on a successful parse.
+   * @return Action<Derived, F> A copy of this parser with the action attached.
+   */
+  template <class F>
+  [[nodiscard]] constexpr Action<Derived, F> action(const F& action) const {
+    return Action<Derived, F>{derived(), action};
+  }
 
   /**
-   * @brief Set the consumer of the parsed string.
+   * @brief Create a parser that invokes a consumer on the parsed string.
+   *
+   * Same as action(), but the consumer is type-erased and called indirectly.
    *
    * @param consumer The consumer to invoke on a successful parse.
+   * @return Action<Derived, Consumer> A copy of this parser with the consumer attached.
    */
-  Derived& consumer(const Consumer& consumer) noexcept {
-    consumer_ = consumer;
-    return *static_cast<Derived*>(this);
+  [[nodiscard]] Action<Derived, Consumer> consumer(const Consumer& consumer) const {
+    return action(consumer);
   }
 
   /**
-   * @brief Parse the given string and apply the consumer on a full parse
+   * @brief Parse the given string
    *
    * @param sv The string to parse
    * @return Result The result of the parse.
    */
-  [[nodiscard]] inline Result parse(const std::string_view& sv) const final {
-    const auto result = parse_it(sv);
+  [[nodiscard]] constexpr Result parse(const std::string_view& sv) const {
+    return derived().parse_it(sv);
+  }
 
-    if (consumer_ && result.success) consumer_(sv.substr(0, sv.size() - result.value.size()));
+  /**
+   * @brief Parse the given string and store the value produced by the parse.
+   *
+   * The value is built in the same pass as the parse: sequences produce a std::tuple of the values
+   * of their parsers, alternatives a std::variant, optional parsers a std::optional and repetitions
+   * a std::vector, or a std::string for repetitions of characters, see attribute_of. Repetitions
+   * append to the container they are given instead of replacing its contents. Parsers that
+   * produce a value provide a `parse_it(const std::string_view&, Attribute&)` function; for
+   * parsers that don't, the attribute is Unused and left untouched.
+   *
+   * @param sv The string to parse
+   * @param attribute Set to the parsed value on a successful parse, unspecified otherwise.
+   * @return Result The result of the parse.
+   */
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse(const std::string_view& sv, Attribute& attribute) const {
+    if constexpr (detail::is_unused_v<attribute_of_t<Derived>>) {
+      return derived().parse_it(sv);
+    } else {
+      return derived().parse_it(sv, attribute);
+    }
+  }
+
+ private:
+  constexpr const Derived& derived() const noexcept { return *static_cast<const Derived*>(this); }
+};
+
+/**
+ * @brief A parser that invokes an action on the string parsed by another parser.
+ *
+ * The action is stored by value and called directly, so that it can be inlined into the parse.
+ *
+ * If the action isn't invocable with the parsed string, but the parser produces a value (see
+ * BaseParser::parse), the action is invoked with that value instead.
+ *
+ * @tparam T The parser whose parsed string or value is passed to the action.
+ * @tparam F The action, invocable with a `std::string_view` or the value of the parser.
+ */
+template <class T, class F>
+class Action : public BaseParser<Action<T, F>> {
+ public:
+  static constexpr CharSet first = T::first;
+  static constexpr bool nullable = T::nullable;
+  static constexpr bool provably_nullable = T::provably_nullable;
+  static constexpr size_t min_width = T::min_width;
+  static constexpr size_t max_width = T::max_width;
+  static constexpr RequiredLiteral required = T::required;
+
+  constexpr Action(const T& parser, const F& action) : parser_{parser}, action_{action} {}
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return parser_.min_length(); }
+
+ protected:
+  friend class BaseParser<Action>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    if constexpr (by_span) {
+      const auto result = parser_.parse(sv);
+
+      if (result.success) action_(sv.substr(0, sv.size() - result.value.size()));
+
+      return result;
+    } else {
+      attribute_of_t<T> attribute{};
+      return parse_it(sv, attribute);
+    }
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    const auto result = parser_.parse(sv, attribute);
+
+    if (result.success) {
+      if constexpr (by_span) {
+        action_(sv.substr(0, sv.size() - result.value.size()));
+      } else {
+        action_(attribute);
+      }
+    }
 
     return result;
   }
 
-  /**
-   * @brief The minimum number of parsed characters that constitute a full
-   * parse
-   */
-  [[nodiscard]] virtual size_t min_length() const noexcept = 0;
+ private:
+  static constexpr bool by_span = std::is_invocable_v<const F&, std::string_view>;
+
+  T parser_;
+  F action_;
+};
+
+/** @brief An action produces the value of its parser. */
+template <class T, class F>
+struct attribute_of<Action<T, F>> {
+  using type = attribute_of_t<T>;
+};
+
+/**
+ * @brief Wraps a parser into the abstract Parser interface.
+ *
+ * @tparam T The parser to wrap.
+ */
+template <class T>
+class Erased final : public Parser {
+ public:
+  explicit Erased(const T& parser) noexcept : parser_{parser} {}
+
+  [[nodiscard]] Result parse(const std::string_view& sv) const override {
+    return parser_.parse(sv);
+  }
+
+  [[nodiscard]] size_t min_length() const noexcept override { return parser_.min_length(); }
+
+ private:
+  T parser_;
+};
+
+/**
+ * @brief A parser that forwards to a type-erased Parser.
+ *
+ * The referenced parser has to outlive this parser. Since the referenced parser may in turn
+ * contain this reference, e.g. for recursive grammars, the minimum length is not looked through
+ * and is always 0.
+ */
+class ParserRef : public BaseParser<ParserRef> {
+ public:
+  explicit ParserRef(const Parser& parser) noexcept : parser_{&parser} {}
+
+  [[nodiscard]] size_t min_length() const noexcept { return 0; }
 
  protected:
-  [[nodiscard]] virtual Result parse_it(const std::string_view& sv) const = 0;
+  friend class BaseParser<ParserRef>;
+
+  [[nodiscard]] Result parse_it(const std::string_view& sv) const { return parser_->parse(sv); }
 
  private:
-  Consumer consumer_;
+  const Parser* parser_;
 };
 
 /** @relates BaseParser @brief Syntactic sugar for calling the parse function. */
 template <class Derived>
-inline Result operator>>(const std::string_view& sv, const BaseParser<Derived>& parser) {
+constexpr Result operator>>(const std::string_view& sv, const BaseParser<Derived>& parser) {
   return parser.parse(sv);
 }
 
 /** @relates BaseParser @brief Syntactic sugar for calling the parse function. */
 template <class Derived>
-inline Result operator>>(const Result& result, const BaseParser<Derived>& parser) {
+constexpr Result operator>>(const Result& result, const BaseParser<Derived>& parser) {
   return parser.parse(result.value);
 }
 
 /**
- * @brief A parser that matches one parser or the other.
+ * @brief Whether a parser matches exactly one character from its `first` set and does nothing else.
  *
- * First tries the first parser and if it fails, tries the second parser.
- * If both fail, the result is a unsuccessful parse.
+ * Alternatives and differences of such parsers are folded into a single character class.
+ */
+template <class T>
+struct is_char_class : std::false_type {};
+
+template <class T>
+inline constexpr bool is_char_class_v = is_char_class<T>::value;
+
+/**
+ * @brief Customization point for merging two adjacent parsers of a sequence into a single parser.
+ *
+ * Specializations derive from std::true_type and provide a static
+ * `merge(const T&, const S&)` function that returns the merged parser.
+ */
+template <class T, class S, class = void>
+struct sequence_merge : std::false_type {};
+
+namespace detail {
+
+template <class T>
+inline constexpr bool is_parser_v = std::is_base_of_v<BaseParser<T>, T>;
+
+/**
+ * @brief Whether a parser has a fixed width and can match without bounds checks.
+ *
+ * Such parsers provide a static `match_at(const char*)` function that tests the next `min_width`
+ * characters, which the caller guarantees to exist. Sequences and fixed repetitions of them are
+ * matched with a single bounds check, see Then and Times.
+ */
+template <class T, class = void>
+struct has_match_at : std::false_type {};
+
+template <class T>
+struct has_match_at<T, std::void_t<decltype(T::match_at(std::declval<const char*>()))>>
+    : std::true_type {};
+
+template <class T>
+inline constexpr bool has_match_at_v = has_match_at<T>::value;
+
+/** @brief The smallest unsigned integer type with at least N bits. */
+template <size_t N>
+using mask_t = std::conditional_t<
+    (N <= 8), uint8_t,
+    std::conditional_t<(N <= 16), uint16_t, std::conditional_t<(N <= 32), uint32_t, uint64_t>>>;
+
+/** @brief A single operand of a parser with several operands. */
+template <size_t I, class T>
+struct Operand {
+  T parser;
+};
+
+template <class Is, class... Ps>
+struct OperandsImpl;
+
+/**
+ * @brief Flat storage for the operands of a parser.
+ *
+ * Unlike std::tuple, this doesn't instantiate a recursive chain of types, which keeps the compile
+ * time of long sequences and alternations low.
+ */
+template <size_t... Is, class... Ps>
+struct OperandsImpl<std::index_sequence<Is...>, Ps...> : Operand<Is, Ps>... {
+  static constexpr size_t size = sizeof...(Ps);
+
+  constexpr explicit OperandsImpl(const Ps&... parsers) noexcept : Operand<Is, Ps>{parsers}... {}
+};
+
+template <class... Ps>
+using Operands = OperandsImpl<std::index_sequence_for<Ps...>, Ps...>;
+
+/** @brief Access the operand at index I. */
+template <size_t I, class T>
+constexpr const T& get(const Operand<I, T>& operand) noexcept {
+  return operand.parser;
+}
+
+/** @brief Invoke f with all operands. */
+template <class F, size_t... Is, class... Ps>
+constexpr decltype(auto) apply(const F& f,
+                               const OperandsImpl<std::index_sequence<Is...>, Ps...>& operands) {
+  return f(get<Is>(operands)...);
+}
+
+/** @brief The alternatives of an Or parser that are viable, by the first character of the input. */
+template <class Mask>
+struct DispatchTable {
+  /** @brief The viable alternatives per first character. */
+  std::array<Mask, 256> by_first{};
+  /** @brief The viable alternatives on an empty input. */
+  Mask on_empty{};
+};
+
+template <class Mask, class... Ps>
+constexpr DispatchTable<Mask> make_dispatch_table() noexcept {
+  DispatchTable<Mask> table;
+  constexpr std::array<CharSet, sizeof...(Ps)> firsts{Ps::first...};
+  constexpr std::array<bool, sizeof...(Ps)> nullables{Ps::nullable...};
+  for (size_t i = 0; i < sizeof...(Ps); ++i) {
+    const auto bit = static_cast<Mask>(Mask{1} << i);
+    if (nullables[i]) table.on_empty |= bit;
+    for (size_t c = 0; c < 256; ++c) {
+      if (nullables[i] || firsts[i].contains(static_cast<char>(c))) table.by_first[c] |= bit;
+    }
+  }
+  return table;
+}
+
+/** @brief The attribute of a sequence: the tuple of the values its parsers produce. */
+template <class Tuple>
+struct collapse_tuple {
+  using type = Tuple;
+};
+
+/** @brief A sequence without values produces none. */
+template <>
+struct collapse_tuple<std::tuple<>> {
+  using type = Unused;
+};
+
+/** @brief A sequence with a single value produces that value. */
+template <class A>
+struct collapse_tuple<std::tuple<A>> {
+  using type = A;
+};
+
+template <class... As>
+using sequence_attribute_t = typename collapse_tuple<decltype(std::tuple_cat(
+    std::declval<std::conditional_t<is_unused_v<As>, std::tuple<>, std::tuple<As>>>()...))>::type;
+
+/** @brief The index of the value of each parser of a sequence in the tuple of the sequence. */
+template <class... As>
+constexpr std::array<size_t, sizeof...(As)> sequence_slots() noexcept {
+  constexpr std::array<bool, sizeof...(As)> used{!is_unused_v<As>...};
+  std::array<size_t, sizeof...(As)> slots{};
+  size_t slot = 0;
+  for (size_t i = 0; i < sizeof...(As); ++i) {
+    slots[i] = slot;
+    if (used[i]) ++slot;
+  }
+  return slots;
+}
+
+template <class... Ts>
+struct TypeList {};
+
+template <class T>
+struct TypeTag {
+  using type = T;
+};
+
+/** @brief Add a type to a list of distinct types, if it isn't in it yet. */
+template <class... Ts, class A>
+constexpr auto operator+(TypeList<Ts...> /*list*/, TypeTag<A> /*type*/) noexcept {
+  if constexpr ((std::is_same_v<Ts, A> || ...)) {
+    return TypeList<Ts...>{};
+  } else {
+    return TypeList<Ts..., A>{};
+  }
+}
+
+/** @brief The value an alternative contributes to the variant. */
+template <class A>
+using alternative_value_t = std::conditional_t<is_unused_v<A>, std::monostate, A>;
+
+template <class List>
+struct alternative_variant;
+
+/** @brief Alternatives that all produce the same value produce that value. */
+template <class A>
+struct alternative_variant<TypeList<A>> {
+  using type = A;
+};
+
+template <class A, class B, class... As>
+struct alternative_variant<TypeList<A, B, As...>> {
+  using type = std::variant<A, B, As...>;
+};
+
+/**
+ * @brief The attribute of alternatives: the variant of the distinct values they produce.
  *
- * @tparam T The first parser that will be tried.
- * @tparam S The second parser that will be tried.
+ * Alternatives without a value contribute std::monostate, unless none of them produces a value.
  */
-template <class T, class S>
-class Or : public BaseParser<Or<T, S>> {
+template <class... As>
+using alternative_attribute_t = typename std::conditional_t<
+    (is_unused_v<As> && ...), TypeTag<Unused>,
+    alternative_variant<decltype((TypeList<>{} + ... + TypeTag<alternative_value_t<As>>{}))>>::type;
+
+}  // namespace detail
+
+/**
+ * @brief A parser that matches one of several parsers.
+ *
+ * Tries the parsers in order and returns the result of the first one that succeeds.
+ * If all fail, the result is a unsuccessful parse.
+ *
+ * Alternatives that can't match the first character of the input, according to their `first` and
+ * `nullable` properties, are skipped without being run. For up to 64 alternatives the viable ones
+ * are looked up in a table indexed by the first character.
+ *
+ * @tparam Ps The parsers that will be tried.
+ */
+template <class... Ps>
+class Or : public BaseParser<Or<Ps...>> {
+  static_assert(sizeof...(Ps) >= 2, "An Or parser needs at least two alternatives");
+
  public:
-  Or(const T& p1, const S& p2) noexcept : parser1_{p1}, parser2_{p2} {}
+  static constexpr CharSet first = (Ps::first | ...);
+  static constexpr bool nullable = (Ps::nullable || ...);
+  static constexpr bool provably_nullable = (Ps::provably_nullable || ...);
+  static constexpr size_t min_width = std::min({Ps::min_width...});
+  static constexpr size_t max_width = std::max({Ps::max_width...});
 
-  [[nodiscard]] size_t min_length() const noexcept override {
-    return std::min(parser1_.min_length(), parser2_.min_length());
+  constexpr explicit Or(const Ps&... parsers) noexcept : parsers_{parsers...} {}
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept {
+    return detail::apply([](const auto&... p) { return std::min({p.min_length()...}); }, parsers_);
+  }
+
+  /** @brief The alternatives of this parser. */
+  [[nodiscard]] constexpr const detail::Operands<Ps...>& parsers() const noexcept {
+    return parsers_;
   }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
-    if (const auto result = sv >> parser1_; result.success) return result;
-    return sv >> parser2_;
+  friend class BaseParser<Or>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    Unused unused;
+    return parse_alternatives(sv, unused, std::index_sequence_for<Ps...>{});
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    return parse_alternatives(sv, attribute, std::index_sequence_for<Ps...>{});
   }
 
  private:
-  T parser1_;
-  S parser2_;
+  static constexpr bool use_table = sizeof...(Ps) <= 64;
+
+  using Mask = detail::mask_t<sizeof...(Ps)>;
+
+  static constexpr auto table_ =
+      use_table ? detail::make_dispatch_table<Mask, Ps...>() : detail::DispatchTable<Mask>{};
+
+  template <size_t I, class P>
+  static constexpr bool is_viable(const std::string_view& sv, [[maybe_unused]] Mask viable) {
+    if constexpr (use_table) {
+      return (viable & (Mask{1} << I)) != 0;
+    } else {
+      return P::nullable || (!sv.empty() && P::first.contains(sv.front()));
+    }
+  }
+
+  template <class Attribute, size_t... Is>
+  constexpr Result parse_alternatives(const std::string_view& sv, Attribute& attribute,
+                                      std::index_sequence<Is...> /*unused*/) const {
+    if (sv.empty()) detail::mark_end();
+
+    Mask viable{};
+    if constexpr (use_table) {
+      viable = sv.empty() ? table_.on_empty
+                          : table_.by_first[static_cast<unsigned char>(sv.front())];
+    }
+
+    Result result{sv, false};
+    (void)((is_viable<Is, Ps>(sv, viable) &&
+            (result = parse_alternative<Is>(sv, attribute)).success) ||
+           ...);
+    return result;
+  }
+
+  /** @brief Parse a single alternative, and on success store its value in the variant. */
+  template <size_t I, class Attribute>
+  constexpr Result parse_alternative(const std::string_view& sv, Attribute& attribute) const {
+    const auto& parser = detail::get<I>(parsers_);
+    using Value = attribute_of_t<std::decay_t<decltype(parser)>>;
+
+    if constexpr (detail::is_unused_v<Attribute>) {
+      return parser.parse(sv);
+    } else if constexpr (std::is_same_v<Value, Attribute>) {
+      return parser.parse(sv, attribute);
+    } else if constexpr (detail::is_unused_v<Value>) {
+      const auto result = parser.parse(sv);
+      if (result.success) attribute = std::monostate{};
+      return result;
+    } else {
+      Value value{};
+      const auto result = parser.parse(sv, value);
+      if (result.success) attribute = std::move(value);
+      return result;
+    }
+  }
+
+  detail::Operands<Ps...> parsers_;
 };
 
-/** @relates Or @brief Syntactic sugar for creating an Or parser. */
-template <class T, class S>
-constexpr Or<T, S> operator|(const T& p1, const S& p2) noexcept {
-  return Or<T, S>{p1, p2};
+/** @brief Alternatives produce the variant of their values, see BaseParser::parse. */
+template <class... Ps>
+struct attribute_of<Or<Ps...>> {
+  using type = detail::alternative_attribute_t<attribute_of_t<Ps>...>;
+};
+
+namespace detail {
+
+/** @brief The operands of a parser, as they are flattened into a Node parser. */
+template <template <class...> class Node, class T>
+constexpr Operands<T> operands(const T& parser) noexcept {
+  return Operands<T>{parser};
+}
+
+/** @brief The operands of a parser that is itself a Node parser. */
+template <template <class...> class Node, class... Ps>
+constexpr const Operands<Ps...>& operands(const Node<Ps...>& parser) noexcept {
+  return parser.parsers();
+}
+
+template <template <class...> class Node, size_t... Is, class... Ps, size_t... Js, class... Qs>
+constexpr Node<Ps..., Qs...> concat(const OperandsImpl<std::index_sequence<Is...>, Ps...>& lhs,
+                                    const OperandsImpl<std::index_sequence<Js...>, Qs...>& rhs) {
+  return Node<Ps..., Qs...>{get<Is>(lhs)..., get<Js>(rhs)...};
+}
+
+/** @brief Create a Node parser from the flattened operands of two parsers. */
+template <template <class...> class Node, class T, class S>
+constexpr auto flatten(const T& p1, const S& p2) noexcept {
+  return concat<Node>(operands<Node>(p1), operands<Node>(p2));
+}
+
+/** @brief Create a Node parser from the given parsers, or return the parser if there is one. */
+template <template <class...> class Node, class P>
+constexpr P make_node(const P& parser) noexcept {
+  return parser;
+}
+
+template <template <class...> class Node, class P, class Q, class... Ps>
+constexpr Node<P, Q, Ps...> make_node(const P& p1, const Q& p2, const Ps&... parsers) noexcept {
+  return Node<P, Q, Ps...>{p1, p2, parsers...};
+}
+
+template <template <class...> class Node, class L, class R, size_t... Is, size_t... Js>
+constexpr auto merge_boundary(const L& lhs, const R& rhs, std::index_sequence<Is...> /*unused*/,
+                              std::index_sequence<Js...> /*unused*/) noexcept {
+  using Last = std::decay_t<decltype(get<sizeof...(Is)>(lhs))>;
+  using First = std::decay_t<decltype(get<0>(rhs))>;
+  return make_node<Node>(get<Is>(lhs)...,
+                         sequence_merge<Last, First>::merge(get<sizeof...(Is)>(lhs), get<0>(rhs)),
+                         get<Js + 1>(rhs)...);
+}
+
+/**
+ * @brief Create a Node parser from the flattened operands of two parsers, merging the last operand
+ * of the first and the first operand of the second parser if possible.
+ */
+template <template <class...> class Node, class T, class S>
+constexpr auto flatten_merged(const T& p1, const S& p2) noexcept {
+  const auto& lhs = operands<Node>(p1);
+  const auto& rhs = operands<Node>(p2);
+  constexpr auto lhs_size = std::decay_t<decltype(lhs)>::size;
+  constexpr auto rhs_size = std::decay_t<decltype(rhs)>::size;
+  using Last = std::decay_t<decltype(get<lhs_size - 1>(lhs))>;
+  using First = std::decay_t<decltype(get<0>(rhs))>;
+
+  if constexpr (sequence_merge<Last, First>::value) {
+    return merge_boundary<Node>(lhs, rhs, std::make_index_sequence<lhs_size - 1>{},
+                                std::make_index_sequence<rhs_size - 1>{});
+  } else {
+    return concat<Node>(lhs, rhs);
+  }
+}
+
+/** @brief The first set of a sequence of parsers. */
+template <class... Ps>
+constexpr CharSet sequence_first() noexcept {
+  constexpr std::array<CharSet, sizeof...(Ps)> firsts{Ps::first...};
+  constexpr std::array<bool, sizeof...(Ps)> nullables{Ps::nullable...};
+  CharSet set;
+  for (size_t i = 0; i < sizeof...(Ps); ++i) {
+    set = set | firsts[i];
+    if (!nullables[i]) break;
+  }
+  return set;
+}
+
+/** @brief The best required literal of a sequence of parsers, see RequiredLiteral. */
+template <class... Ps>
+constexpr RequiredLiteral sequence_required() noexcept {
+  constexpr std::array<RequiredLiteral, sizeof...(Ps)> literals{Ps::required...};
+  constexpr std::array<size_t, sizeof...(Ps)> min_widths{Ps::min_width...};
+  constexpr std::array<size_t, sizeof...(Ps)> max_widths{Ps::max_width...};
+  RequiredLiteral best;
+  size_t min = 0;
+  size_t max = 0;
+  for (size_t i = 0; i < sizeof...(Ps); ++i) {
+    if (literals[i].size != 0 && literals[i].shifted(min, max).better_than(best)) {
+      best = literals[i].shifted(min, max);
+    }
+    min = add_widths(min, min_widths[i]);
+    max = add_widths(max, max_widths[i]);
+  }
+  return best;
+}
+
+}  // namespace detail
+
+/**
+ * @relates Or @brief Syntactic sugar for creating an Or parser.
+ *
+ * Chained alternatives are flattened into a single Or parser. Alternatives of two character
+ * classes are folded into one instead, see built_in::CharClass.
+ */
+template <class T, class S,
+          class = std::enable_if_t<detail::is_parser_v<T> && detail::is_parser_v<S> &&
+                                   !(is_char_class_v<T> && is_char_class_v<S>)>>
+constexpr auto operator|(const T& p1, const S& p2) noexcept {
+  return detail::flatten<Or>(p1, p2);
 }
 
 /**
  * @brief A parser that matches a sequence of parsers.
  *
- * Only tries the second parser if the first one succeeds.
+ * Only tries a parser if all previous ones succeeded. If any of them fails, the result is an
+ * unsuccessful parse of the whole input.
  *
- * @tparam T The first parser that will be tried.
- * @tparam S The second parser that will be tried.
+ * @tparam Ps The parsers that will be tried in order.
  */
-template <class T, class S>
-class Then : public BaseParser<Then<T, S>> {
+template <class... Ps>
+class Then : public BaseParser<Then<Ps...>> {
+  static_assert(sizeof...(Ps) >= 2, "A Then parser needs at least two parsers");
+
  public:
-  Then(const T& p1, const S& p2) noexcept : parser1_{p1}, parser2_{p2} {}
+  static constexpr CharSet first = detail::sequence_first<Ps...>();
+  static constexpr bool nullable = (Ps::nullable && ...);
+  static constexpr bool provably_nullable = (Ps::provably_nullable && ...);
+  static constexpr size_t min_width = detail::sum_widths({Ps::min_width...});
+  static constexpr size_t max_width = detail::sum_widths({Ps::max_width...});
+  static constexpr RequiredLiteral required = detail::sequence_required<Ps...>();
+
+  constexpr explicit Then(const Ps&... parsers) noexcept : parsers_{parsers...} {}
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept {
+    return detail::apply([](const auto&... p) { return detail::sum_widths({p.min_length()...}); },
+                         parsers_);
+  }
 
-  [[nodiscard]] size_t min_length() const noexcept override {
-    return parser1_.min_length() + parser2_.min_length();
+  /** @brief Match the next min_width characters without bounds checks, see detail::has_match_at. */
+  template <bool Enabled = (detail::has_match_at_v<Ps> && ...),
+            std::enable_if_t<Enabled, int> = 0>
+  [[nodiscard]] static constexpr bool match_at(const char* data) noexcept {
+    return match_all(data, std::index_sequence_for<Ps...>{});
+  }
+
+  /** @brief The sequence of parsers of this parser. */
+  [[nodiscard]] constexpr const detail::Operands<Ps...>& parsers() const noexcept {
+    return parsers_;
   }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
-    auto result = sv >> parser1_;
+  friend class BaseParser<Then>;
 
-    if (!result.success) return {sv, false};
-    result = result >> parser2_;
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    if (detail::too_short(sv, min_width)) return {sv, false};
+    if constexpr ((detail::has_match_at_v<Ps> && ...)) {
+      // Sequences of fixed width parsers, e.g. a date, take a single bounds check.
+      if (match_at(sv.data())) return {sv.substr(min_width), true};
+      return {sv, false};
+    } else {
+      Unused unused;
+      return parse_sequence(sv, unused, std::index_sequence_for<Ps...>{});
+    }
+  }
 
-    if (!result.success) return {sv, false};
-    return result;
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    if (detail::too_short(sv, min_width)) return {sv, false};
+    return parse_sequence(sv, attribute, std::index_sequence_for<Ps...>{});
   }
 
  private:
-  T parser1_;
-  S parser2_;
+  /** @brief The distance of each operand from the start of a match, if all have a fixed width. */
+  static constexpr std::array<size_t, sizeof...(Ps)> offsets = [] {
+    constexpr std::array<size_t, sizeof...(Ps)> widths{Ps::min_width...};
+    std::array<size_t, sizeof...(Ps)> result{};
+    for (size_t i = 1; i < result.size(); ++i) result[i] = result[i - 1] + widths[i - 1];
+    return result;
+  }();
+
+  template <size_t... Is>
+  static constexpr bool match_all(const char* data,
+                                  std::index_sequence<Is...> /*unused*/) noexcept {
+    return (Ps::match_at(data + offsets[Is]) && ...);
+  }
+
+  template <class Attribute, size_t... Is>
+  constexpr Result parse_sequence(const std::string_view& sv, Attribute& attribute,
+                                  std::index_sequence<Is...> /*unused*/) const {
+    Result result{sv, true};
+    if (((result = parse_operand<Is>(result.value, attribute)).success && ...)) return result;
+    return {sv, false};
+  }
+
+  /** @brief Parse a single operand, storing its value in its slot of the tuple. */
+  template <size_t I, class Attribute>
+  constexpr Result parse_operand(const std::string_view& sv, Attribute& attribute) const {
+    const auto& parser = detail::get<I>(parsers_);
+    using Value = attribute_of_t<std::decay_t<decltype(parser)>>;
+
+    if constexpr (detail::is_unused_v<Attribute> || detail::is_unused_v<Value>) {
+      return parser.parse(sv);
+    } else if constexpr (((!detail::is_unused_v<attribute_of_t<Ps>>)+...) == 1) {
+      return parser.parse(sv, attribute);
+    } else {
+      constexpr auto slots = detail::sequence_slots<attribute_of_t<Ps>...>();
+      return parser.parse(sv, std::get<slots[I]>(attribute));
+    }
+  }
+
+  detail::Operands<Ps...> parsers_;
 };
 
-/** @relates Then @brief Syntactic sugar for creating a Then parser. */
-template <class T, class S>
-constexpr Then<T, S> operator&(const T& p1, const S& p2) noexcept {
-  return Then<T, S>{p1, p2};
+/** @brief Sequences produce the tuple of their values, see BaseParser::parse. */
+template <class... Ps>
+struct attribute_of<Then<Ps...>> {
+  using type = detail::sequence_attribute_t<attribute_of_t<Ps>...>;
+};
+
+/**
+ * @relates Then @brief Syntactic sugar for creating a Then parser.
+ *
+ * Chained sequences are flattened into a single Then parser. Adjacent parsers that can be merged
+ * into one, see sequence_merge, are merged, e.g. a sequence of characters into a literal.
+ */
+template <class T, class S,
+          class = std::enable_if_t<detail::is_parser_v<T> && detail::is_parser_v<S>>>
+constexpr auto operator&(const T& p1, const S& p2) noexcept {
+  return detail::flatten_merged<Then>(p1, p2);
 }
 
 /**
@@ -207,50 +1091,272 @@ constexpr Then<T, S> operator&(const T& p1, const S& p2) noexcept {
 template <class T>
 class Optional : public BaseParser<Optional<T>> {
  public:
-  explicit Optional(const T& parser) noexcept : parser_{parser} {}
+  static constexpr CharSet first = T::first;
+  static constexpr bool nullable = true;
+  static constexpr bool provably_nullable = true;
+  static constexpr size_t max_width = T::max_width;
+
+  constexpr explicit Optional(const T& parser) noexcept : parser_{parser} {}
 
-  [[nodiscard]] size_t min_length() const noexcept override { return 0; }
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 0; }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
+  friend class BaseParser<Optional>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
     return {parser_.parse(sv).value, true};
   }
 
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    typename Attribute::value_type value{};
+    const auto result = parser_.parse(sv, value);
+    if (result.success) {
+      attribute = std::move(value);
+    } else {
+      attribute.reset();
+    }
+    return {result.value, true};
+  }
+
  private:
   T parser_;
 };
 
+/** @brief Optional parsers produce an optional value, see BaseParser::parse. */
+template <class T>
+struct attribute_of<Optional<T>> {
+  using type = std::conditional_t<detail::is_unused_v<attribute_of_t<T>>, Unused,
+                                  std::optional<attribute_of_t<T>>>;
+};
+
 /** @relates Optional @brief Syntactic sugar for creating an Optional parser. */
 template <class T>
 constexpr Optional<T> operator~(const T& parser) noexcept {
   return Optional<T>{parser};
 }
 
+namespace detail {
+
+/**
+ * @brief Whether the next character rules out a match of the parser, from its FIRST set alone.
+ *
+ * Only parsers that always consume input can be ruled out like that.
+ */
+template <class T>
+constexpr bool first_rules_out(const std::string_view& sv) noexcept {
+  return !T::nullable && !sv.empty() && !T::first.contains(sv.front());
+}
+
+}  // namespace detail
+
+/**
+ * @brief A parser that succeeds if the given parser matches, without consuming any input.
+ *
+ * Lookahead for "followed by", e.g. to tell a keyword from an identifier without backtracking.
+ * Lookahead at a character class is a single test of the next character, other parsers are first
+ * checked against their `first` set and only run if the next character could start a match.
+ *
+ * @tparam T The parser to look ahead with.
+ */
+template <class T>
+class And : public BaseParser<And<T>> {
+ public:
+  static constexpr CharSet first = CharSet{};
+  static constexpr bool nullable = true;
+  static constexpr bool provably_nullable = true;
+  static constexpr size_t max_width = 0;
+
+  constexpr explicit And(const T& parser) noexcept : parser_{parser} {}
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 0; }
+
+ protected:
+  friend class BaseParser<And>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    if constexpr (is_char_class_v<T>) {
+      if (sv.empty()) {
+        detail::mark_end();
+        return {sv, false};
+      }
+      return {sv, T::first.contains(sv.front())};
+    } else {
+      if (detail::first_rules_out<T>(sv)) return {sv, false};
+      return {sv, parser_.parse(sv).success};
+    }
+  }
+
+ private:
+  T parser_;
+};
+
+/** @relates And @brief Create a parser that checks that the input continues with a match. */
+template <class T>
+constexpr And<T> followed_by(const T& parser) noexcept {
+  return And<T>{parser};
+}
+
+/**
+ * @brief A parser that succeeds if the given parser doesn't match, without consuming any input.
+ *
+ * Lookahead for "not followed by", e.g. `Lit<"if"> & !alphanumeric` matches the keyword, but not
+ * the start of the identifier "iffy". Checked like And.
+ *
+ * @tparam T The parser to look ahead with.
+ */
+template <class T>
+class Not : public BaseParser<Not<T>> {
+ public:
+  static constexpr CharSet first = CharSet{};
+  static constexpr bool nullable = true;
+  static constexpr bool provably_nullable = true;
+  static constexpr size_t max_width = 0;
+
+  constexpr explicit Not(const T& parser) noexcept : parser_{parser} {}
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 0; }
+
+ protected:
+  friend class BaseParser<Not>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    if constexpr (is_char_class_v<T>) {
+      if (sv.empty()) {
+        detail::mark_end();
+        return {sv, true};
+      }
+      return {sv, !T::first.contains(sv.front())};
+    } else {
+      if (detail::first_rules_out<T>(sv)) return {sv, true};
+      return {sv, !parser_.parse(sv).success};
+    }
+  }
+
+ private:
+  T parser_;
+};
+
+/** @relates Not @brief Create a parser that checks that the input doesn't continue with a match. */
+template <class T>
+constexpr Not<T> not_followed_by(const T& parser) noexcept {
+  return Not<T>{parser};
+}
+
+/** @relates Not @brief Syntactic sugar for creating a Not parser. */
+template <class T, class = std::enable_if_t<detail::is_parser_v<T>>>
+constexpr Not<T> operator!(const T& parser) noexcept {
+  return Not<T>{parser};
+}
+
+namespace detail {
+
+/** @brief The attribute of a repetition: the container of the values of the repeated parser. */
+template <class A>
+struct container_of {
+  using type = std::vector<A>;
+};
+
+/** @brief Repetitions of characters produce a string. */
+template <>
+struct container_of<char> {
+  using type = std::string;
+};
+
+template <>
+struct container_of<Unused> {
+  using type = Unused;
+};
+
+template <class A>
+using container_of_t = typename container_of<A>::type;
+
+/** @brief Parse one repetition of a parser and append its value to the container. */
+template <class T, class Container>
+constexpr Result parse_element(const T& parser, const std::string_view& sv,
+                               Container& container) {
+  if constexpr (is_unused_v<Container>) {
+    return parser.parse(sv);
+  } else {
+    typename Container::value_type value{};
+    const auto result = parser.parse(sv, value);
+    if (result.success) container.push_back(std::move(value));
+    return result;
+  }
+}
+
+/** @brief Append the characters matched by a scan over a character class to the container. */
+template <class Container>
+constexpr void append_chars(Container& container, const std::string_view& chars) {
+  if constexpr (!is_unused_v<Container>) {
+    container.insert(container.end(), chars.begin(), chars.end());
+  }
+}
+
+}  // namespace detail
+
 /**
  * @brief A parser that matches the given parser zero or more times.
  *
+ * Repetitions of a character class are matched with a vectorized scan, see detail::span.
+ *
  * @tparam T The parser to match.
  */
 template <class T>
 class Many : public BaseParser<Many<T>> {
+  static_assert(!T::provably_nullable,
+                "Many would never end, its parser can succeed without consuming input");
+
  public:
-  explicit Many(const T& parser) noexcept : parser_{parser} {}
+  static constexpr CharSet first = T::first;
+  static constexpr bool nullable = true;
+  static constexpr bool provably_nullable = true;
+  static constexpr size_t max_width = T::max_width == 0 ? 0 : unbounded;
+
+  constexpr explicit Many(const T& parser) noexcept : parser_{parser} {}
 
-  [[nodiscard]] size_t min_length() const noexcept override { return 0; }
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 0; }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
-    auto result = sv >> parser_;
-    while (result.success) {
-      result = result >> parser_;
+  friend class BaseParser<Many>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    Unused unused;
+    return parse_it(sv, unused);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    if constexpr (is_char_class_v<T>) {
+      const auto i = detail::span<T>(sv);
+      if (i == sv.size()) detail::mark_end();
+      detail::append_chars(attribute, sv.substr(0, i));
+      return {sv.substr(i), true};
+    } else {
+      auto rest = sv;
+      while (true) {
+        const auto result = detail::parse_element(parser_, rest, attribute);
+        if (!result.success) break;
+        // An element that consumed nothing would match again forever, see provably_nullable.
+        if (T::nullable && result.value.size() == rest.size()) break;
+        rest = result.value;
+      }
+      return {rest, true};
     }
-    return {result.value, true};
   }
 
  private:
   T parser_;
 };
 
+/** @brief Repetitions produce a container of their values, see BaseParser::parse. */
+template <class T>
+struct attribute_of<Many<T>> {
+  using type = detail::container_of_t<attribute_of_t<T>>;
+};
+
 /** @relates Many @brief Syntactic sugar for creating parser that matches zero or more
  * characters */
 template <class T>
@@ -261,33 +1367,110 @@ constexpr Many<T> operator*(const T& parser) noexcept {
 /**
  * @brief A parser that matches the given parser an exact number of times.
  *
+ * The count is either given at run time, or fixed at compile time with N, see repeat. A fixed count
+ * makes the width of the parser known at compile time, e.g. `repeat<4>(digit)` has a min_width and
+ * max_width of 4, and lets the compiler unroll the repetitions.
+ *
  * @tparam T The parser to match.
+ * @tparam N The number of repetitions, or dynamic_count if it is given at run time.
  */
-template <class T>
-class Times : public BaseParser<Times<T>> {
+template <class T, size_t N = dynamic_count>
+class Times : public BaseParser<Times<T, N>> {
+  static constexpr bool is_fixed = N != dynamic_count;
+
  public:
-  Times(size_t times, const T& parser) noexcept : times_{times}, parser_{parser} {}
+  static constexpr CharSet first = is_fixed && N == 0 ? CharSet{} : T::first;
+  static constexpr bool nullable = (is_fixed && N == 0) || T::nullable;
+  static constexpr bool provably_nullable = (is_fixed && N == 0) || T::provably_nullable;
+  static constexpr size_t min_width =
+      is_fixed ? detail::multiply_width(T::min_width, N) : T::min_width;
+  static constexpr size_t max_width = is_fixed ? detail::multiply_width(T::max_width, N)
+                                               : (T::max_width == 0 ? 0 : unbounded);
+  static constexpr RequiredLiteral required =
+      is_fixed && N == 0 ? RequiredLiteral{} : T::required;
 
-  [[nodiscard]] size_t min_length() const noexcept override {
-    return parser_.min_length() * times_;
+  constexpr Times(size_t times, const T& parser) noexcept : times_{times}, parser_{parser} {
+    static_assert(!is_fixed, "The count of this Times parser is fixed at compile time");
+  }
+
+  constexpr explicit Times(const T& parser) noexcept : times_{}, parser_{parser} {
+    static_assert(is_fixed, "The count of this Times parser has to be given");
+  }
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept {
+    return detail::multiply_width(parser_.min_length(), times_.value());
+  }
+
+  /** @brief Match the next min_width characters without bounds checks, see detail::has_match_at. */
+  template <bool Enabled = is_fixed && detail::has_match_at_v<T>,
+            std::enable_if_t<Enabled, int> = 0>
+  [[nodiscard]] static constexpr bool match_at(const char* data) noexcept {
+    for (size_t i = 0; i < N; ++i) {
+      if (!T::match_at(data + i * T::min_width)) return false;
+    }
+    return true;
   }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
-    size_t i = 1;
-    auto result = sv >> parser_;
-    for (; result.success && i < times_; ++i) {
-      result = result >> parser_;
+  friend class BaseParser<Times>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    const auto count = times_.value();
+    const auto width = detail::multiply_width(T::min_width, count);
+    if (detail::too_short(sv, width)) return {sv, false};
+    if constexpr (detail::has_match_at_v<T>) {
+      // A single bounds check for all repetitions, see Then. Like below, a count of 0 given at run
+      // time doesn't match.
+      if (is_fixed || count != 0) {
+        for (size_t i = 0; i < count; ++i) {
+          if (!T::match_at(sv.data() + i * T::min_width)) return {sv, false};
+        }
+        return {sv.substr(width), true};
+      }
     }
+    Unused unused;
+    return parse_repetitions(sv, unused);
+  }
 
-    return (i == times_ && result.success) ? result : Result{sv, false};
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    if (detail::too_short(sv, detail::multiply_width(T::min_width, times_.value()))) {
+      return {sv, false};
+    }
+    return parse_repetitions(sv, attribute);
   }
 
  private:
-  const size_t times_;
+  template <class Attribute>
+  constexpr Result parse_repetitions(const std::string_view& sv, Attribute& attribute) const {
+    if constexpr (is_fixed) {
+      Result result{sv, true};
+      for (size_t i = 0; i < N; ++i) {
+        result = detail::parse_element(parser_, result.value, attribute);
+        if (!result.success) return {sv, false};
+      }
+      return result;
+    } else {
+      size_t i = 1;
+      auto result = detail::parse_element(parser_, sv, attribute);
+      for (; result.success && i < times_.value(); ++i) {
+        result = detail::parse_element(parser_, result.value, attribute);
+      }
+
+      return (i == times_.value() && result.success) ? result : Result{sv, false};
+    }
+  }
+
+  detail::Count<N> times_;
   T parser_;
 };
 
+template <class T, size_t N>
+struct attribute_of<Times<T, N>> {
+  using type = detail::container_of_t<attribute_of_t<T>>;
+};
+
 /** @relates Times @brief Syntactic sugar for creating parser that matches an exact number of
  * times */
 template <class T>
@@ -302,30 +1485,72 @@ constexpr Times<T> operator*(const T& parser, size_t times) noexcept {
   return Times<T>{times, parser};
 }
 
+/** @relates Times @brief Create a parser that matches a parser a number of times fixed at compile
+ * time */
+template <size_t N, class T>
+constexpr Times<T, N> repeat(const T& parser) noexcept {
+  static_assert(N != dynamic_count, "The count of repeat has to be fixed");
+  return Times<T, N>{parser};
+}
+
 /**
  * @brief A parser that matches the given parser more than a given number of
  * times.
  *
+ * Repetitions of a character class are matched with a vectorized scan, see detail::span.
+ *
  * @tparam T The parser to match.
  */
 template <class T>
 class GreaterThan : public BaseParser<GreaterThan<T>> {
+  static_assert(!T::provably_nullable,
+                "GreaterThan would never end, its parser can succeed without consuming input");
+
  public:
-  GreaterThan(size_t min, const T& parser) noexcept : min_{min}, parser_{parser} {}
+  static constexpr CharSet first = T::first;
+  static constexpr bool nullable = T::nullable;
+  static constexpr bool provably_nullable = T::provably_nullable;
+  static constexpr size_t min_width = T::min_width;
+  static constexpr size_t max_width = T::max_width == 0 ? 0 : unbounded;
+  static constexpr RequiredLiteral required = T::required;
 
-  [[nodiscard]] size_t min_length() const noexcept override {
+  constexpr GreaterThan(size_t min, const T& parser) noexcept : min_{min}, parser_{parser} {}
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept {
     return (min_ + 1) * parser_.min_length();
   }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
-    size_t i = 0;
-    auto result = sv >> parser_;
-    while (result.success) {
-      ++i;
-      result = result >> parser_;
+  friend class BaseParser<GreaterThan>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    Unused unused;
+    return parse_it(sv, unused);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    if constexpr (is_char_class_v<T>) {
+      const auto i = detail::span<T>(sv);
+      if (i == sv.size()) detail::mark_end();
+      if (min_ >= i) return {sv, false};
+      detail::append_chars(attribute, sv.substr(0, i));
+      return {sv.substr(i), true};
+    } else {
+      size_t i = 0;
+      auto rest = sv;
+      while (true) {
+        const auto result = detail::parse_element(parser_, rest, attribute);
+        if (!result.success) break;
+        // An element that consumed nothing would match again forever, see provably_nullable. The
+        // repetitions still missing would match nothing as well, so the minimum is met.
+        if (T::nullable && result.value.size() == rest.size()) return {rest, true};
+        ++i;
+        rest = result.value;
+      }
+      return (min_ < i) ? Result{rest, true} : Result{sv, false};
     }
-    return (min_ < i) ? Result{result.value, true} : Result{sv, false};
   }
 
  private:
@@ -333,6 +1558,11 @@ class GreaterThan : public BaseParser<GreaterThan<T>> {
   T parser_;
 };
 
+template <class T>
+struct attribute_of<GreaterThan<T>> {
+  using type = detail::container_of_t<attribute_of_t<T>>;
+};
+
 /** @relates GreaterThan @brief Syntactic sugar for creating a GreaterThan parser. */
 template <class T>
 constexpr GreaterThan<T> operator<(size_t minimum, const T& parser) noexcept {
@@ -361,17 +1591,33 @@ constexpr GreaterThan<T> operator+(const T& parser) noexcept {
 template <class T>
 class LessThan : public BaseParser<LessThan<T>> {
  public:
-  LessThan(size_t max, const T& parser) noexcept : max_{max}, parser_{parser} {}
-  [[nodiscard]] size_t min_length() const noexcept override { return 0; }
+  static constexpr CharSet first = T::first;
+  static constexpr bool nullable = T::nullable;
+  static constexpr bool provably_nullable = T::provably_nullable;
+  static constexpr size_t min_width = T::min_width;
+  static constexpr size_t max_width = T::max_width == 0 ? 0 : unbounded;
+  static constexpr RequiredLiteral required = T::required;
+
+  constexpr LessThan(size_t max, const T& parser) noexcept : max_{max}, parser_{parser} {}
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 0; }
 
  protected:
-  [[nodiscard]] Result parse_it(const std::string_view& sv) const override {
-    auto result = sv >> parser_;
+  friend class BaseParser<LessThan>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    Unused unused;
+    return parse_it(sv, unused);
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    auto result = detail::parse_element(parser_, sv, attribute);
     auto success = result.success;
     // Start at 2 because we already ran the parser once and want to stop at
     // max_ - 1
     for (size_t i = 2; result.success && i < max_; ++i) {
-      result = result >> parser_;
+      result = detail::parse_element(parser_, result.value, attribute);
       success |= result.success;
     }
 
@@ -383,6 +1629,11 @@ class LessThan : public BaseParser<LessThan<T>> {
   T parser_;
 };
 
+template <class T>
+struct attribute_of<LessThan<T>> {
+  using type = detail::container_of_t<attribute_of_t<T>>;
+};
+
 /** @relates LessThan @brief Syntactic sugar for creating a LessThan parser. */
 template <class T>
 constexpr LessThan<T> operator<(const T& parser, size_t maximum) noexcept {
@@ -395,4 +1646,82 @@ constexpr LessThan<T> operator>(size_t maximum, const T& parser) noexcept {
   return LessThan<T>{maximum, parser};
 }
 
+/**
+ * @brief A parser that matches the given parser zero or more times and folds their values.
+ *
+ * Like Many, but instead of collecting the values of the repetitions in a container, they are
+ * combined as they are parsed: the value starts out as `init`, and becomes `f(value, element)`
+ * after every repetition. The element is the value of the parser, or the string it parsed if it
+ * doesn't produce a value.
+ *
+ * @tparam T The parser to match.
+ * @tparam Value The value produced by the fold.
+ * @tparam F The function combining the value with an element.
+ */
+template <class T, class Value, class F>
+class Fold : public BaseParser<Fold<T, Value, F>> {
+  static_assert(!T::provably_nullable,
+                "Fold would never end, its parser can succeed without consuming input");
+
+ public:
+  using attribute_type = Value;
+
+  static constexpr CharSet first = T::first;
+  static constexpr bool nullable = true;
+  static constexpr bool provably_nullable = true;
+  static constexpr size_t max_width = T::max_width == 0 ? 0 : unbounded;
+
+  constexpr Fold(const T& parser, const Value& init, const F& f)
+      : parser_{parser}, init_{init}, f_{f} {}
+
+  [[nodiscard]] constexpr size_t min_length() const noexcept { return 0; }
+
+ protected:
+  friend class BaseParser<Fold>;
+
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv) const {
+    auto rest = sv;
+    while (true) {
+      const auto result = parser_.parse(rest);
+      if (!result.success) break;
+      // An element that consumed nothing would match again forever, see provably_nullable.
+      if (T::nullable && result.value.size() == rest.size()) break;
+      rest = result.value;
+    }
+    return {rest, true};
+  }
+
+  template <class Attribute>
+  [[nodiscard]] constexpr Result parse_it(const std::string_view& sv,
+                                          Attribute& attribute) const {
+    attribute = init_;
+    auto rest = sv;
+    while (true) {
+      attribute_of_t<T> element{};
+      const auto result = parser_.parse(rest, element);
+      if (!result.success) break;
+
+      if constexpr (detail::is_unused_v<attribute_of_t<T>>) {
+        attribute = f_(std::move(attribute), rest.substr(0, rest.size() - result.value.size()));
+      } else {
+        attribute = f_(std::move(attribute), std::move(element));
+      }
+      if (T::nullable && result.value.size() == rest.size()) break;
+      rest = result.value;
+    }
+    return {rest, true};
+  }
+
+ private:
+  T parser_;
+  Value init_;
+  F f_;
+};
+
+/** @relates Fold @brief Syntactic sugar for creating a Fold parser. */
+template <class T, class Value, class F>
+constexpr Fold<T, Value, F> fold(const T& parser, const Value& init, const F& f) {
+  return Fold<T, Value, F>{parser, init, f};
+}
+
 }  // namespace tiny_parse
@@ -1,14 +1,39 @@
 #include <tiny_parse/built_in.hpp>
+#include <tiny_parse/floating.hpp>
+#include <tiny_parse/mapped_input.hpp>
+#include <tiny_parse/memo.hpp>
+#include <tiny_parse/multi_literal.hpp>
+#include <tiny_parse/numeric.hpp>
+#include <tiny_parse/parallel.hpp>
+#include <tiny_parse/search.hpp>
+#include <tiny_parse/stream.hpp>
+#include <tiny_parse/symbols.hpp>
+#include <tiny_parse/thread_pool.hpp>
 #include <tiny_parse/tiny_parse.hpp>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
 
 TEST_SUITE_BEGIN("tiny_parse");
 
@@ -47,6 +72,94 @@ TEST_CASE("AnyP") {
   CHECK(parser.parse("") == Result{"", false});
 }
 
+TEST_CASE("LitP") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  const auto get = LitP<'G', 'E', 'T'>{};
+  CHECK(get.min_length() == 3);
+  CHECK(get.parse("GET /") == Result{" /", true});
+  CHECK(get.parse("GE") == Result{"GE", false});
+  CHECK(get.parse("PUT") == Result{"PUT", false});
+  CHECK(get.parse("") == Result{"", false});
+  static_assert(get.parse("GETS") == Result{"S", true});
+  static_assert(!get.parse("GEX"));
+
+  SUBCASE("All lengths") {
+    const std::string text{"abcdefghijklmnopqrstuvwxyz"};
+    const auto check = [&](auto parser, size_t length) {
+      CHECK(parser.parse(text) == Result{std::string_view{text}.substr(length), true});
+      CHECK(parser.parse(text.substr(0, length - 1)).success == false);
+      std::string wrong = text;
+      wrong[length - 1] = '_';
+      CHECK(parser.parse(wrong).success == false);
+    };
+    check(LitP<'a'>{}, 1);
+    check(LitP<'a', 'b', 'c'>{}, 3);
+    check(LitP<'a', 'b', 'c', 'd', 'e'>{}, 5);
+    check(LitP<'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k'>{}, 11);
+    check(LitP<'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q',
+               'r', 's', 't'>{},
+          20);
+  }
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+  SUBCASE("From a string") {
+    static_assert(std::is_same_v<Lit<"GET">, LitP<'G', 'E', 'T'>>);
+  }
+#endif
+}
+
+TEST_CASE("CharClass") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  SUBCASE("Alternatives are folded") {
+    const auto hex = digit | RangeP<'a', 'f'>{} | RangeP<'A', 'F'>{};
+    static_assert(is_char_class_v<std::decay_t<decltype(hex)>>);
+    static_assert(std::is_same_v<decltype(CharP<'a'>{} | CharP<'b'>{}),
+                                 decltype(CharP<'b'>{} | CharP<'a'>{})>);
+    CHECK(hex.min_length() == 1);
+    CHECK(hex.parse("f0") == Result{"0", true});
+    CHECK(hex.parse("C") == Result{"", true});
+    CHECK(hex.parse("g") == Result{"g", false});
+    CHECK(hex.parse("") == Result{"", false});
+  }
+
+  SUBCASE("Built-ins are classes") {
+    static_assert(is_char_class_v<std::decay_t<decltype(letter)>>);
+    static_assert(is_char_class_v<std::decay_t<decltype(alphanumeric)>>);
+    static_assert(is_char_class_v<std::decay_t<decltype(whitespace)>>);
+    CHECK(whitespace.parse("\t ") == Result{" ", true});
+    CHECK(alphanumeric.parse("_") == Result{"_", false});
+  }
+
+  SUBCASE("Difference") {
+    const auto consonant = letter - (CharP<'a'>{} | CharP<'e'>{} | CharP<'i'>{} | CharP<'o'>{} |
+                                     CharP<'u'>{});
+    CHECK(consonant.parse("b") == Result{"", true});
+    CHECK(consonant.parse("e") == Result{"e", false});
+    CHECK(consonant.parse("1") == Result{"1", false});
+  }
+
+  SUBCASE("Complement") {
+    const auto not_digit = -digit;
+    CHECK(not_digit.parse("a") == Result{"", true});
+    CHECK(not_digit.parse("\xff") == Result{"", true});
+    CHECK(not_digit.parse("5") == Result{"5", false});
+    CHECK(not_digit.parse("") == Result{"", false});
+    static_assert(std::is_same_v<decltype(-not_digit), decltype(AnyP{} - not_digit)>);
+  }
+
+  SUBCASE("From a set") {
+    static constexpr auto set = CharSet::single('x') | CharSet::range('0', '1');
+    constexpr auto parser = CharClassOf<set>{};
+    static_assert(parser.parse("x") == Result{"", true});
+    static_assert(parser.parse("1") == Result{"", true});
+    static_assert(parser.parse("2") == Result{"2", false});
+  }
+}
+
 template <bool throws = false>
 struct Consumer {
   explicit Consumer(std::string expected) : expected_{std::move(expected)} {}
@@ -146,6 +259,42 @@ TEST_CASE("Consumer") {
   }
 }
 
+TEST_CASE("Action") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  std::string parsed;
+  const auto parser = (+digit).action([&](std::string_view sv) { parsed += sv; });
+  CHECK(parser.min_length() == 1);
+
+  SUBCASE("Valid case") {
+    CHECK(parser.parse("123a") == Result{"a", true});
+    CHECK(parsed == "123");
+  }
+
+  SUBCASE("Invalid case") {
+    CHECK(parser.parse("a123") == Result{"a123", false});
+    CHECK(parsed.empty());
+  }
+
+  SUBCASE("Inside a then") {
+    const auto list = parser & *(CharP<','>{} & parser);
+    CHECK(list.parse("1,23,4") == Result{"", true});
+    CHECK(parsed == "1234");
+  }
+
+  SUBCASE("constexpr") {
+    constexpr auto noop = CharP<'a'>{}.action([](std::string_view) {});
+    static_assert(noop.parse("ab") == Result{"b", true});
+  }
+}
+
+template <size_t... Is>
+constexpr auto make_wide_or(std::index_sequence<Is...> /*unused*/) {
+  return tiny_parse::Or<tiny_parse::built_in::CharP<static_cast<char>('0' + Is)>...>{
+      tiny_parse::built_in::CharP<static_cast<char>('0' + Is)>{}...};
+}
+
 TEST_CASE("Or") {
   using namespace tiny_parse;
   using namespace tiny_parse::built_in;
@@ -156,6 +305,37 @@ TEST_CASE("Or") {
   CHECK(parser.parse("b") == Result{"", true});
   CHECK(parser.parse("c") == Result{"c", false});
   CHECK(parser.parse("") == Result{"", false});
+
+  SUBCASE("Flattening") {
+    const auto a = +CharP<'a'>{};
+    const auto b = +CharP<'b'>{};
+    using Flat = Or<GreaterThan<CharP<'a'>>, GreaterThan<CharP<'b'>>, GreaterThan<CharP<'a'>>>;
+    static_assert(std::is_same_v<decltype(a | (b | a)), Flat>);
+    static_assert(std::is_same_v<decltype(a | b | a), Flat>);
+  }
+
+  SUBCASE("First set") {
+    static_assert(decltype(parser)::first == (CharSet::single('a') | CharSet::single('b')));
+    static_assert(!decltype(parser)::nullable);
+    static_assert(decltype(parser | ~CharP<'c'>{})::nullable);
+  }
+
+  SUBCASE("Keeps order of viable alternatives") {
+    const auto ordered = (CharP<'a'>{} & CharP<'b'>{}) | ~CharP<'x'>{} | (CharP<'a'>{} * 2);
+    CHECK(ordered.min_length() == 0);
+    CHECK(ordered.parse("ab") == Result{"", true});
+    CHECK(ordered.parse("aa") == Result{"aa", true});
+    CHECK(ordered.parse("x") == Result{"", true});
+    CHECK(ordered.parse("") == Result{"", true});
+  }
+
+  SUBCASE("More than 64 alternatives") {
+    const auto wide = make_wide_or(std::make_index_sequence<70>{});
+    CHECK(wide.parse("0") == Result{"", true});
+    CHECK(wide.parse("u") == Result{"", true});
+    CHECK(wide.parse("v") == Result{"v", false});
+    CHECK(wide.parse("") == Result{"", false});
+  }
 }
 
 TEST_CASE("Then") {
@@ -168,6 +348,37 @@ TEST_CASE("Then") {
   CHECK(parser.parse("a") == Result{"a", false});
   CHECK(parser.parse("b") == Result{"b", false});
   CHECK(parser.parse("") == Result{"", false});
+
+  SUBCASE("Flattening") {
+    const auto a = +CharP<'a'>{};
+    const auto b = +CharP<'b'>{};
+    using Flat = Then<GreaterThan<CharP<'a'>>, GreaterThan<CharP<'b'>>, GreaterThan<CharP<'a'>>>;
+    static_assert(std::is_same_v<decltype(a & (b & a)), Flat>);
+    static_assert(std::is_same_v<decltype(a & b & a), Flat>);
+  }
+
+  SUBCASE("Merges characters into literals") {
+    static_assert(std::is_same_v<decltype(parser), const LitP<'a', 'b'>>);
+    static_assert(std::is_same_v<decltype(parser & (CharP<'c'>{} & CharP<'d'>{})),
+                                 LitP<'a', 'b', 'c', 'd'>>);
+    static_assert(std::is_same_v<decltype(digit & CharP<'a'>{} & CharP<'b'>{} & digit),
+                                 Then<RangeP<'0', '9'>, LitP<'a', 'b'>, RangeP<'0', '9'>>>);
+  }
+
+  SUBCASE("First set") {
+    static_assert(decltype(parser)::first == CharSet::single('a'));
+    static_assert(decltype(~parser & CharP<'c'>{})::first ==
+                  (CharSet::single('a') | CharSet::single('c')));
+    static_assert(!decltype(~parser & CharP<'c'>{})::nullable);
+    static_assert(decltype(~parser & *CharP<'c'>{})::nullable);
+  }
+
+  SUBCASE("Restores input on late failure") {
+    const auto record = digit & CharP<','>{} & digit & CharP<','>{} & digit;
+    CHECK(record.min_length() == 5);
+    CHECK(record.parse("1,2,3;") == Result{";", true});
+    CHECK(record.parse("1,2,x") == Result{"1,2,x", false});
+  }
 }
 
 TEST_CASE("Optional") {
@@ -197,6 +408,26 @@ TEST_CASE("Many") {
   }
 }
 
+TEST_CASE("Repetitions of character classes") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  const auto odd = CharP<'1'>{} | CharP<'3'>{} | CharP<'5'>{} | CharP<'7'>{} | CharP<'9'>{};
+  const auto high = RangeP<'\x80', '\xff'>{};
+
+  for (const size_t length : {0, 1, 15, 16, 17, 31, 32, 33, 100}) {
+    const std::string run(length, '7');
+    const std::string high_run(length, '\xe0');
+
+    CHECK((*digit).parse(run + "a7") == Result{"a7", true});
+    CHECK((*odd).parse(run + "8") == Result{"8", true});
+    CHECK((*-letter).parse(run + "a") == Result{"a", true});
+    CHECK((*high).parse(high_run + "a") == Result{"a", true});
+    CHECK((+digit).parse(run) == Result{"", length > 0});
+    CHECK((digit > 31).parse(run + "a") == Result{length > 31 ? "a" : run + "a", length > 31});
+  }
+}
+
 TEST_CASE("Times") {
   using namespace tiny_parse;
   using namespace tiny_parse::built_in;
@@ -213,6 +444,98 @@ TEST_CASE("Times") {
 
   SUBCASE("<parser> * 3") { perform_checks(CharP<'a'>{} * 3); }
   SUBCASE("3 * <parser>") { perform_checks(3 * CharP<'a'>{}); }
+  SUBCASE("repeat<3>(<parser>)") { perform_checks(repeat<3>(CharP<'a'>{})); }
+
+  SUBCASE("Fixed count") {
+    using Year = decltype(repeat<4>(digit));
+    static_assert(Year::min_width == 4);
+    static_assert(Year::max_width == 4);
+    static_assert(!Year::nullable);
+    static_assert(Year::first == CharSet::range('0', '9'));
+    static_assert(decltype(3 * digit)::max_width == unbounded);
+    static_assert(decltype(repeat<2>(+digit))::min_width == 2);
+    static_assert(decltype(repeat<2>(+digit))::max_width == unbounded);
+    static_assert(decltype(repeat<2>(~digit))::nullable);
+
+    using None = decltype(repeat<0>(digit));
+    static_assert(None::nullable);
+    static_assert(None::max_width == 0);
+    CHECK(repeat<0>(digit).parse("12") == Result{"12", true});
+
+    const auto date = repeat<4>(digit) & CharP<'-'>{} & repeat<2>(digit);
+    static_assert(decltype(date)::min_width == 7);
+    static_assert(decltype(date)::max_width == 7);
+    std::string year;
+    CHECK(repeat<4>(digit).parse("2024-01", year) == Result{"-01", true});
+    CHECK(year == "2024");
+    CHECK(date.parse("2024-01") == Result{"", true});
+    CHECK(date.parse("2024-1") == Result{"2024-1", false});
+    static_assert(repeat<2>(CharP<'a'>{}).parse("aab") == Result{"b", true});
+  }
+
+  SUBCASE("Huge counts") {
+    // Widths saturate at unbounded instead of wrapping around.
+    constexpr size_t huge = unbounded / 2;
+    using Huge = decltype(repeat<huge>(LitP<'a', 'b'>{}));
+    static_assert(Huge::min_width == unbounded - 1);
+    static_assert(decltype(repeat<huge + 1>(LitP<'a', 'b'>{}))::min_width == unbounded);
+    static_assert(decltype(std::declval<Huge>() & std::declval<Huge>())::min_width == unbounded);
+    static_assert(decltype(std::declval<Huge>() & std::declval<Huge>())::max_width == unbounded);
+
+    const auto many = huge * LitP<'a', 'b'>{};
+    CHECK(many.min_length() == unbounded - 1);
+    CHECK((many & many).min_length() == unbounded);
+  }
+
+  SUBCASE("Fixed width") {
+    const auto time = repeat<2>(digit) & CharP<':'>{} & 2 * digit & LitP<'Z', '!'>{};
+    static_assert(tiny_parse::detail::has_match_at_v<decltype(repeat<2>(digit))>);
+    static_assert(!tiny_parse::detail::has_match_at_v<decltype(2 * digit)>);
+    static_assert(!tiny_parse::detail::has_match_at_v<decltype(time)>);
+    static_assert(
+        tiny_parse::detail::has_match_at_v<decltype(repeat<2>(digit) & CharP<':'>{} & AnyP{})>);
+    static_assert(!tiny_parse::detail::has_match_at_v<decltype(+digit & CharP<':'>{})>);
+
+    const auto clock = repeat<2>(digit) & CharP<':'>{} & repeat<2>(digit);
+    CHECK(clock.parse("12:34:56") == Result{":56", true});
+    CHECK(clock.parse("12:3x") == Result{"12:3x", false});
+    CHECK(clock.parse("1a:34") == Result{"1a:34", false});
+    CHECK(time.parse("12:34Z!") == Result{"", true});
+    CHECK(time.parse("12:34Z?") == Result{"12:34Z?", false});
+    CHECK((3 * LitP<'a', 'b'>{}).parse("abababab") == Result{"ab", true});
+    CHECK((3 * LitP<'a', 'b'>{}).parse("ababa") == Result{"ababa", false});
+    CHECK((0 * digit).parse("12") == Result{"12", false});
+
+    // Inputs shorter than the sequence are rejected up front, more input could complete them.
+    tiny_parse::detail::reached_end = false;
+    CHECK(clock.parse("1x:") == Result{"1x:", false});
+    CHECK(tiny_parse::detail::reached_end);
+    tiny_parse::detail::reached_end = false;
+    CHECK(clock.parse("1x:34") == Result{"1x:34", false});
+    CHECK(!tiny_parse::detail::reached_end);
+  }
+
+  SUBCASE("Short inputs") {
+    // Sequences and repetitions of any parsers reject inputs shorter than their min_width before
+    // running a single operand.
+    size_t runs = 0;
+    const auto number = (+digit).action([&](std::string_view) { ++runs; });
+    const auto range = number & CharP<'-'>{} & number;
+    static_assert(!tiny_parse::detail::has_match_at_v<decltype(range)>);
+    static_assert(decltype(range)::min_width == 3);
+
+    tiny_parse::detail::reached_end = false;
+    CHECK(range.parse("1-") == Result{"1-", false});
+    CHECK(tiny_parse::detail::reached_end);
+    CHECK((3 * number).parse("12") == Result{"12", false});
+    CHECK(repeat<3>(number).parse("12") == Result{"12", false});
+    std::vector<std::string> numbers;
+    CHECK((3 * +digit).parse("12", numbers) == Result{"12", false});
+    CHECK(runs == 0);
+
+    CHECK(range.parse("1-2") == Result{"", true});
+    CHECK(runs == 2);
+  }
 }
 
 TEST_CASE("GreaterThan") {
@@ -276,6 +599,1196 @@ TEST_CASE("LessThan") {
   }
 }
 
+TEST_CASE("Attributes") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  SUBCASE("Types") {
+    static_assert(std::is_same_v<attribute_of_t<RangeP<'a', 'z'>>, char>);
+    static_assert(std::is_same_v<attribute_of_t<CharP<','>>, Unused>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(digit & CharP<','>{})>, char>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(digit & CharP<','>{} & letter)>,
+                                 std::tuple<char, char>>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(letter | digit)>, char>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(+digit | CharP<'-'>{})>,
+                                 std::variant<std::string, std::monostate>>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(~digit)>, std::optional<char>>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(*(digit & letter))>,
+                                 std::vector<std::tuple<char, char>>>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(*CharP<'a'>{})>, Unused>);
+    static_assert(std::is_same_v<attribute_of_t<decltype(3 * digit)>, std::string>);
+  }
+
+  SUBCASE("Sequence") {
+    std::tuple<char, char> attribute;
+    CHECK((digit & CharP<','>{} & letter).parse("1,a!", attribute) == Result{"!", true});
+    CHECK(attribute == std::tuple<char, char>{'1', 'a'});
+  }
+
+  SUBCASE("Repetitions") {
+    std::string digits;
+    CHECK((+digit).parse("123a", digits) == Result{"a", true});
+    CHECK(digits == "123");
+
+    std::string letters;
+    CHECK((letter < 3).parse("abc", letters) == Result{"c", true});
+    CHECK(letters == "ab");
+    CHECK((letter < 3).parse("de", letters) == Result{"", true});
+    CHECK(letters == "abde");
+
+    std::vector<std::string> numbers;
+    const auto list = +(+digit & ~CharP<','>{});
+    CHECK(list.parse("1,23,456", numbers) == Result{"", true});
+    CHECK(numbers == std::vector<std::string>{"1", "23", "456"});
+
+    std::string fixed;
+    CHECK((2 * letter).parse("xyz", fixed) == Result{"z", true});
+    CHECK(fixed == "xy");
+  }
+
+  SUBCASE("Alternatives") {
+    const Symbols<int> words{{"one", 1}, {"two", 2}};
+    const auto parser = words | digit | CharP<'-'>{};
+    std::variant<int, char, std::monostate> attribute;
+    CHECK(parser.parse("two", attribute) == Result{"", true});
+    CHECK(attribute == decltype(attribute){2});
+    CHECK(parser.parse("7", attribute) == Result{"", true});
+    CHECK(attribute == decltype(attribute){'7'});
+    CHECK(parser.parse("-", attribute) == Result{"", true});
+    CHECK(std::holds_alternative<std::monostate>(attribute));
+    CHECK(parser.parse("x", attribute) == Result{"x", false});
+  }
+
+  SUBCASE("Optional") {
+    const auto parser = ~(CharP<'-'>{} | CharP<'+'>{}) & whole_number;
+    std::tuple<std::optional<char>, std::string> attribute;
+    CHECK(parser.parse("+12", attribute) == Result{"", true});
+    CHECK(attribute == decltype(attribute){'+', "12"});
+    attribute = {};
+    CHECK(parser.parse("34", attribute) == Result{"", true});
+    CHECK(attribute == decltype(attribute){std::nullopt, "34"});
+  }
+
+  SUBCASE("Fold") {
+    const auto value = fold(digit, 0, [](int sum, char c) { return 10 * sum + (c - '0'); });
+    int attribute = -1;
+    CHECK(value.parse("1234x", attribute) == Result{"x", true});
+    CHECK(attribute == 1234);
+    CHECK(value.parse("x", attribute) == Result{"x", true});
+    CHECK(attribute == 0);
+    CHECK(value.parse("42") == Result{"", true});
+
+    const auto count = fold(LitP<'a', 'b'>{}, size_t{0},
+                            [](size_t n, std::string_view sv) { return n + sv.size(); });
+    size_t length = 0;
+    CHECK(count.parse("ababa", length) == Result{"a", true});
+    CHECK(length == 4);
+  }
+
+  SUBCASE("Action") {
+    std::vector<std::string> words;
+    const auto word = (+letter).action([&](const std::string& w) { words.push_back(w); });
+    CHECK((word & *(CharP<' '>{} & word)).parse("ab cd e") == Result{"", true});
+    CHECK(words == std::vector<std::string>{"ab", "cd", "e"});
+  }
+
+  SUBCASE("constexpr") {
+    constexpr auto parse = [] {
+      std::tuple<char, char> attribute{};
+      (void)(letter & CharP<'='>{} & digit).parse("x=4", attribute);
+      return attribute;
+    };
+    static_assert(parse() == std::tuple<char, char>{'x', '4'});
+  }
+}
+
+TEST_CASE("Integers") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  SUBCASE("uint_") {
+    uint64_t value = 0;
+    CHECK(uint_<uint64_t>.parse("0", value) == Result{"", true});
+    CHECK(value == 0);
+    CHECK(uint_<uint64_t>.parse("1234567890123x", value) == Result{"x", true});
+    CHECK(value == 1234567890123);
+    CHECK(uint_<uint64_t>.parse("18446744073709551615", value) == Result{"", true});
+    CHECK(value == std::numeric_limits<uint64_t>::max());
+    CHECK(uint_<uint64_t>.parse("000000000000000000000042", value) == Result{"", true});
+    CHECK(value == 42);
+    CHECK(uint_<uint64_t>.parse("18446744073709551616", value) ==
+          Result{"18446744073709551616", false});
+    CHECK(uint_<uint64_t>.parse("99999999999999999999999", value) ==
+          Result{"99999999999999999999999", false});
+    CHECK(uint_<uint64_t>.parse("x1", value) == Result{"x1", false});
+    CHECK(uint_<uint64_t>.parse("", value) == Result{"", false});
+    CHECK(uint_<uint64_t>.min_length() == 1);
+
+    // Every length, with and without a character after the digits.
+    std::string digits;
+    uint64_t expected = 0;
+    for (int i = 1; i <= 19; ++i) {
+      digits += static_cast<char>('0' + i % 10);
+      expected = expected * 10 + static_cast<uint64_t>(i % 10);
+      CHECK(uint_<uint64_t>.parse(digits, value) == Result{"", true});
+      CHECK(value == expected);
+      CHECK(uint_<uint64_t>.parse(digits + "/123456789", value) == Result{"/123456789", true});
+      CHECK(value == expected);
+    }
+
+    // Random runs of digits, compared with std::from_chars.
+    uint32_t state = 1;
+    const auto next = [&] { return (state = state * 1103515245U + 12345U) >> 16U; };
+    for (int i = 0; i < 2000; ++i) {
+      std::string input(next() % 8 == 0 ? next() % 12 : 0, '0');
+      const auto length = next() % 24;
+      for (uint32_t j = 0; j < length; ++j) input += static_cast<char>('0' + next() % 10);
+      if (next() % 2 == 0) input += "x12345678";
+
+      uint64_t expected_value = 0;
+      const auto [end, error] =
+          std::from_chars(input.data(), input.data() + input.size(), expected_value);
+      const auto result = uint_<uint64_t>.parse(input, value);
+      CHECK(result.success == (error == std::errc{}));
+      if (error != std::errc{}) continue;
+      CHECK(value == expected_value);
+      CHECK(result.value.data() == end);
+    }
+  }
+
+  SUBCASE("Ranges") {
+    uint8_t octet = 0;
+    CHECK(uint_<uint8_t>.parse("255.", octet) == Result{".", true});
+    CHECK(octet == 255);
+    CHECK(uint_<uint8_t>.parse("256", octet) == Result{"256", false});
+    CHECK(uint_<uint8_t>.parse("1000", octet) == Result{"1000", false});
+
+    const auto month = uint_<unsigned, 1, 12>;
+    unsigned value = 0;
+    CHECK(month.parse("12", value) == Result{"", true});
+    CHECK(value == 12);
+    CHECK(month.parse("0", value) == Result{"0", false});
+    CHECK(month.parse("13", value) == Result{"13", false});
+  }
+
+  SUBCASE("int_") {
+    int64_t value = 0;
+    CHECK(int_<int64_t>.parse("-42,", value) == Result{",", true});
+    CHECK(value == -42);
+    CHECK(int_<int64_t>.parse("+42", value) == Result{"", true});
+    CHECK(value == 42);
+    CHECK(int_<int64_t>.parse("-9223372036854775808", value) == Result{"", true});
+    CHECK(value == std::numeric_limits<int64_t>::min());
+    CHECK(int_<int64_t>.parse("9223372036854775807", value) == Result{"", true});
+    CHECK(value == std::numeric_limits<int64_t>::max());
+    CHECK(int_<int64_t>.parse("9223372036854775808", value) ==
+          Result{"9223372036854775808", false});
+    CHECK(int_<int64_t>.parse("-", value) == Result{"-", false});
+    CHECK(int_<int64_t>.parse("--1", value) == Result{"--1", false});
+
+    int8_t small = 0;
+    CHECK(int_<int8_t>.parse("-128", small) == Result{"", true});
+    CHECK(small == -128);
+    CHECK(int_<int8_t>.parse("128", small) == Result{"128", false});
+    CHECK(int_<int, -5, 5>.parse("-6") == Result{"-6", false});
+    CHECK(int_<int, -5, 5>.parse("-5") == Result{"", true});
+  }
+
+  SUBCASE("hex_") {
+    uint32_t value = 0;
+    CHECK(hex_<uint32_t>.parse("DeadBeef!", value) == Result{"!", true});
+    CHECK(value == 0xDEADBEEF);
+    CHECK(hex_<uint32_t>.parse("0000000000ff", value) == Result{"", true});
+    CHECK(value == 0xFF);
+    CHECK(hex_<uint32_t>.parse("100000000", value) == Result{"100000000", false});
+    CHECK(hex_<uint32_t>.parse("g", value) == Result{"g", false});
+  }
+
+  SUBCASE("digits") {
+    unsigned year = 0;
+    CHECK(digits<4>.parse("2024-01", year) == Result{"-01", true});
+    CHECK(year == 2024);
+    CHECK(digits<4>.parse("20245", year) == Result{"5", true});
+    CHECK(digits<4>.parse("202", year) == Result{"202", false});
+    CHECK(digits<4>.parse("20x4", year) == Result{"20x4", false});
+
+    uint64_t id = 0;
+    CHECK(digits<12, uint64_t>.parse("000123456789", id) == Result{"", true});
+    CHECK(id == 123456789);
+    CHECK(digits<12, uint64_t>.parse("00012345678x", id) == Result{"00012345678x", false});
+    CHECK(digits<16, uint64_t>.parse("1234567812345678", id) == Result{"", true});
+    CHECK(id == 1234567812345678);
+  }
+
+  SUBCASE("In a grammar") {
+    const auto date = digits<4> & CharP<'-'>{} & digits<2> & CharP<'-'>{} & digits<2>;
+    std::tuple<unsigned, unsigned, unsigned> attribute;
+    CHECK(date.parse("2024-02-29", attribute) == Result{"", true});
+    CHECK(attribute == std::tuple<unsigned, unsigned, unsigned>{2024, 2, 29});
+
+    std::vector<int> numbers;
+    const auto list = int_<> & *(CharP<','>{} & int_<>);
+    CHECK((+(int_<> & ~CharP<','>{})).parse("1,-2,3", numbers) == Result{"", true});
+    CHECK(numbers == std::vector<int>{1, -2, 3});
+    CHECK(list.parse("1,2,") == Result{",", true});
+  }
+
+  SUBCASE("End of input") {
+    tiny_parse::detail::reached_end = false;
+    CHECK(uint_<>.parse("12 ") == Result{" ", true});
+    CHECK(!tiny_parse::detail::reached_end);
+    CHECK(uint_<>.parse("12") == Result{"", true});
+    CHECK(tiny_parse::detail::reached_end);
+    tiny_parse::detail::reached_end = false;
+    CHECK(digits<4>.parse("12") == Result{"12", false});
+    CHECK(tiny_parse::detail::reached_end);
+  }
+
+  SUBCASE("constexpr") {
+    static_assert(uint_<>.parse("123") == Result{"", true});
+    static_assert(int_<>.parse("-1a") == Result{"a", true});
+    static_assert(digits<3>.parse("12") == Result{"12", false});
+    constexpr auto value = [] {
+      unsigned year = 0;
+      (void)digits<4>.parse("1999", year);
+      return year;
+    }();
+    static_assert(value == 1999);
+  }
+}
+
+TEST_CASE("Floating point") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  SUBCASE("double_") {
+    double value = 0;
+    CHECK(double_.parse("3.14", value) == Result{"", true});
+    CHECK(value == 3.14);
+    CHECK(double_.parse("-0", value) == Result{"", true});
+    CHECK((value == 0 && std::signbit(value)));
+    CHECK(double_.parse("+1e10,", value) == Result{",", true});
+    CHECK(value == 1e10);
+    CHECK(double_.parse("5.", value) == Result{"", true});
+    CHECK(value == 5);
+    CHECK(double_.parse(".5", value) == Result{"", true});
+    CHECK(value == 0.5);
+    CHECK(double_.parse("2.5E-3x", value) == Result{"x", true});
+    CHECK(value == 2.5e-3);
+    CHECK(double_.parse("12e", value) == Result{"e", true});
+    CHECK(value == 12);
+    CHECK(double_.parse("12e+x", value) == Result{"e+x", true});
+    CHECK(value == 12);
+    CHECK(double_.parse(".", value) == Result{".", false});
+    CHECK(double_.parse("-", value) == Result{"-", false});
+    CHECK(double_.parse("e5", value) == Result{"e5", false});
+    CHECK(double_.parse("", value) == Result{"", false});
+    CHECK(double_.min_length() == 1);
+  }
+
+  SUBCASE("Infinity and NaN") {
+    double value = 0;
+    CHECK(double_.parse("inf", value) == Result{"", true});
+    CHECK(value == std::numeric_limits<double>::infinity());
+    CHECK(double_.parse("-Infinity!", value) == Result{"!", true});
+    CHECK(value == -std::numeric_limits<double>::infinity());
+    CHECK(double_.parse("infinite", value) == Result{"inite", true});
+    CHECK(double_.parse("NaN", value) == Result{"", true});
+    CHECK(std::isnan(value));
+    CHECK(double_.parse("in", value) == Result{"in", false});
+  }
+
+  SUBCASE("Edge cases") {
+    double value = 0;
+    // Halfway between two doubles, rounds to even.
+    CHECK(double_.parse("9007199254740993", value) == Result{"", true});
+    CHECK(value == 9007199254740992.0);
+    CHECK(double_.parse("2.2250738585072011e-308", value) == Result{"", true});
+    CHECK(value == 2.2250738585072011e-308);
+    CHECK(double_.parse("1.7976931348623157e308", value) == Result{"", true});
+    CHECK(value == std::numeric_limits<double>::max());
+    CHECK(double_.parse("4.9406564584124654e-324", value) == Result{"", true});
+    CHECK(value == std::numeric_limits<double>::denorm_min());
+    CHECK(double_.parse("2.4703282292062328e-324", value) == Result{"", true});
+    CHECK(value == std::numeric_limits<double>::denorm_min());
+    CHECK(double_.parse("1e-400", value) == Result{"", true});
+    CHECK(value == 0);
+    CHECK(double_.parse("0e999999999", value) == Result{"", true});
+    CHECK(value == 0);
+    CHECK(double_.parse("1e999", value) == Result{"1e999", false});
+    CHECK(double_.parse("-1.8e308", value) == Result{"-1.8e308", false});
+
+    // More digits than fit into the mantissa.
+    CHECK(double_.parse("1234567890123456789012345", value) == Result{"", true});
+    CHECK(value == 1234567890123456789012345.0);
+    CHECK(double_.parse("0.000000000000000000000000000001234567890123456789", value) ==
+          Result{"", true});
+    CHECK(value == 1.234567890123456789e-30);
+    CHECK(double_.parse("9007199254740993.0000000000000000000001", value) == Result{"", true});
+    CHECK(value == 9007199254740994.0);
+    CHECK(double_.parse("9007199254740992.9999999999999999999999", value) == Result{"", true});
+    CHECK(value == 9007199254740992.0);
+
+    // Long digit sequences can make up for large exponents.
+    const auto tiny = "0." + std::string(700000, '0') + "1e700001";
+    CHECK(double_.parse(tiny, value) == Result{"", true});
+    CHECK(value == 1.0);
+    const auto huge = "1" + std::string(700000, '0') + "e-700000";
+    CHECK(double_.parse(huge, value) == Result{"", true});
+    CHECK(value == 1.0);
+
+    float small = 0;
+    CHECK(float_.parse("16777217", small) == Result{"", true});
+    CHECK(small == 16777216.0f);
+    CHECK(float_.parse("3.4028235e38", small) == Result{"", true});
+    CHECK(small == std::numeric_limits<float>::max());
+    CHECK(float_.parse("3.5e38", small) == Result{"3.5e38", false});
+    CHECK(float_.parse("1.4e-45", small) == Result{"", true});
+    CHECK(small == std::numeric_limits<float>::denorm_min());
+
+    // Just above the midpoint between two floats, past the digits the mantissa holds. Both the
+    // from_chars and the strtod fallback have to round it up, once.
+    const std::string_view midpoint = "1.00000005960464477539062500001";
+    const auto above_one = std::nextafter(1.0f, 2.0f);
+    CHECK(float_.parse(midpoint, small) == Result{"", true});
+    CHECK(small == above_one);
+    small = 0;
+    CHECK(tiny_parse::detail::convert_with_strtod(midpoint, small));
+    CHECK(small == above_one);
+    CHECK(tiny_parse::detail::convert_with_strtod(std::string_view{"9007199254740993"}, value));
+    CHECK(value == 9007199254740992.0);
+    CHECK(!tiny_parse::detail::convert_with_strtod(std::string_view{"1e999"}, value));
+  }
+
+  SUBCASE("json_number") {
+    double value = 0;
+    CHECK(json_number.parse("-12.5e+2", value) == Result{"", true});
+    CHECK(value == -1250);
+    CHECK(json_number.parse("0", value) == Result{"", true});
+    CHECK(json_number.parse("01", value) == Result{"1", true});
+    CHECK(value == 0);
+    CHECK(json_number.parse("1.", value) == Result{".", true});
+    CHECK(value == 1);
+    CHECK(json_number.parse("+1", value) == Result{"+1", false});
+    CHECK(json_number.parse(".5", value) == Result{".5", false});
+    CHECK(json_number.parse("inf", value) == Result{"inf", false});
+    CHECK(json_number.parse("-", value) == Result{"-", false});
+  }
+
+  SUBCASE("Random numbers compared with std::from_chars") {
+    uint32_t state = 1;
+    const auto next = [&] { return (state = state * 1103515245U + 12345U) >> 16U; };
+    const auto digits = [&](uint32_t count) {
+      std::string result;
+      for (uint32_t i = 0; i < count; ++i) result += static_cast<char>('0' + next() % 10);
+      return result;
+    };
+    for (int i = 0; i < 4000; ++i) {
+      auto input = digits(1 + next() % 24);
+      if (next() % 2 == 0) input += "." + digits(next() % 24);
+      if (next() % 2 == 0) input += "e" + std::to_string(static_cast<int>(next() % 700) - 350);
+
+      double expected = 0;
+      double value = 0;
+      const auto [end, error] = std::from_chars(input.data(), input.data() + input.size(),
+                                                expected);
+      if (error == std::errc{}) {
+        CHECK(end == input.data() + input.size());
+        CHECK(double_.parse(input, value) == Result{"", true});
+        CHECK(value == expected);
+      }
+
+      float expected_float = 0;
+      float value_float = 0;
+      const auto result = std::from_chars(input.data(), input.data() + input.size(),
+                                          expected_float);
+      if (result.ec == std::errc{}) {
+        CHECK(float_.parse(input, value_float) == Result{"", true});
+        CHECK(value_float == expected_float);
+      }
+    }
+  }
+
+  SUBCASE("In a grammar") {
+    const auto point = CharP<'('>{} & double_ & CharP<','>{} & double_ & CharP<')'>{};
+    std::tuple<double, double> attribute;
+    CHECK(point.parse("(1.5,-2e3)", attribute) == Result{"", true});
+    CHECK(attribute == std::tuple<double, double>{1.5, -2e3});
+
+    CHECK(number.parse("3.14") == Result{"", true});
+    CHECK(number.parse("-42.") == Result{".", true});
+  }
+
+  SUBCASE("End of input") {
+    tiny_parse::detail::reached_end = false;
+    CHECK(double_.parse("1.5 ") == Result{" ", true});
+    CHECK(!tiny_parse::detail::reached_end);
+    CHECK(double_.parse("1.5e") == Result{"e", true});
+    CHECK(tiny_parse::detail::reached_end);
+    tiny_parse::detail::reached_end = false;
+    CHECK(double_.parse("in") == Result{"in", false});
+    CHECK(tiny_parse::detail::reached_end);
+  }
+}
+
+TEST_CASE("constexpr") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  static_assert(CharP<'a'>{}.parse("ab") == Result{"b", true});
+  static_assert(RangeP<'0', '9'>{}.parse("a") == Result{"a", false});
+  static_assert(AnyP{}.parse("") == Result{"", false});
+  static_assert((CharP<'a'>{} | CharP<'b'>{}).parse("bc") == Result{"c", true});
+  static_assert((CharP<'a'>{} & CharP<'b'>{}).parse("ac") == Result{"ac", false});
+  static_assert((~CharP<'a'>{}).parse("b") == Result{"b", true});
+  static_assert((*CharP<'a'>{}).parse("aab") == Result{"b", true});
+  static_assert((2 * CharP<'a'>{}).parse("aab") == Result{"b", true});
+  static_assert((1 < CharP<'a'>{}).parse("ab") == Result{"ab", false});
+  static_assert((CharP<'a'>{} < 2).parse("aab") == Result{"ab", true});
+  static_assert(decimal.parse("-3.14") == Result{"", true});
+  static_assert(decimal.min_length() == 3);
+
+  constexpr auto key = letter & *(alphanumeric | underscore);
+  static_assert(key.parse("max_depth=3") == Result{"=3", true});
+  static_assert(!key.parse("3d"));
+}
+
+TEST_CASE("Memo") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  MemoTable table{4};
+  size_t runs = 0;
+  const auto number = memo((+digit).action([&](std::string_view) { ++runs; }), table);
+  const auto parser = (number & CharP<'a'>{}) | (number & CharP<'b'>{}) | number;
+  CHECK(parser.min_length() == 1);
+
+  SUBCASE("Reuses results") {
+    const std::string_view input{"123b"};
+    CHECK(parser.parse(input) == Result{"", true});
+    CHECK(runs == 1);
+    CHECK(table.size() == 1);
+  }
+
+  SUBCASE("Memoizes failures") {
+    const auto pair = memo(CharP<'1'>{} & CharP<'2'>{}, table);
+    CHECK(((pair & CharP<'a'>{}) | pair).parse("13") == Result{"13", false});
+    CHECK(table.size() == 1);
+  }
+
+  SUBCASE("Clear") {
+    const std::string input{"1b"};
+    CHECK(parser.parse(input) == Result{"", true});
+    table.clear();
+    CHECK(table.size() == 0);
+    CHECK(parser.parse(input) == Result{"", true});
+    CHECK(runs == 2);
+  }
+
+  SUBCASE("Grows") {
+    const std::string input(100, '1');
+    const auto digits = *memo(digit, table);
+    CHECK(digits.parse(input) == Result{"", true});
+    CHECK(table.size() == 101);
+    CHECK(digits.parse(input) == Result{"", true});
+    CHECK(table.size() == 101);
+  }
+
+  SUBCASE("Prefix views") {
+    const std::string_view input{"1234b"};
+    CHECK(number.parse(input) == Result{"b", true});
+    // Same start, but a shorter view, must not reuse the result of the longer one.
+    CHECK(number.parse(input.substr(0, 2)) == Result{"", true});
+    CHECK(runs == 2);
+    CHECK(table.size() == 2);
+  }
+
+  SUBCASE("Replays reaching the end") {
+    const std::string_view input{"12"};
+    tiny_parse::detail::reached_end = false;
+    CHECK(number.parse(input) == Result{"", true});
+    CHECK(tiny_parse::detail::reached_end);
+
+    tiny_parse::detail::reached_end = false;
+    CHECK(number.parse(input) == Result{"", true});
+    CHECK(tiny_parse::detail::reached_end);
+    CHECK(runs == 1);
+
+    const std::string_view other{"12a"};
+    tiny_parse::detail::reached_end = true;
+    CHECK(number.parse(other) == Result{"a", true});
+    // An earlier mark is kept, but not memoized.
+    CHECK(tiny_parse::detail::reached_end);
+    tiny_parse::detail::reached_end = false;
+    CHECK(number.parse(other) == Result{"a", true});
+    CHECK(!tiny_parse::detail::reached_end);
+  }
+}
+
+TEST_CASE("MultiLiteralSearcher") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  using Matches = std::vector<std::pair<size_t, size_t>>;
+  const auto search = [](const MultiLiteralSearcher& searcher, std::string_view sv) {
+    Matches matches;
+    searcher.search(sv,
+                    [&](size_t pattern, size_t offset) { matches.emplace_back(pattern, offset); });
+    return matches;
+  };
+
+  SUBCASE("Overlapping matches") {
+    const MultiLiteralSearcher searcher{"he", "she", "his", "hers"};
+    CHECK(searcher.size() == 4);
+    CHECK(search(searcher, "ushers") == Matches{{1, 1}, {0, 2}, {3, 2}});
+    CHECK(search(searcher, "ahishe") == Matches{{2, 1}, {1, 3}, {0, 4}});
+    CHECK(search(searcher, "xyz").empty());
+    CHECK(search(searcher, "").empty());
+  }
+
+  SUBCASE("Duplicate patterns") {
+    const MultiLiteralSearcher searcher{"ab", "ab", "b"};
+    CHECK(search(searcher, "abab") == Matches{{0, 0}, {1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 3}});
+  }
+
+  SUBCASE("Sparse states") {
+    std::vector<std::string> patterns;
+    for (int i = 0; i < 300; ++i) patterns.push_back(std::to_string(i * 7919 % 1000));
+    const MultiLiteralSearcher dense{patterns.begin(), patterns.end(), 4096};
+    const MultiLiteralSearcher sparse{patterns.begin(), patterns.end(), 1};
+
+    std::string text;
+    for (int i = 0; i < 2000; ++i) text += static_cast<char>('0' + (i * 31 + i / 7) % 11);
+
+    Matches expected;
+    for (size_t end = 1; end <= text.size(); ++end) {
+      for (size_t length = std::min<size_t>(end, 3); length > 0; --length) {
+        for (size_t p = 0; p < patterns.size(); ++p) {
+          if (text.compare(end - length, length, patterns[p]) == 0) {
+            expected.emplace_back(p, end - length);
+          }
+        }
+      }
+    }
+    CHECK(!expected.empty());
+    CHECK(search(dense, text) == expected);
+    CHECK(search(sparse, text) == expected);
+  }
+
+  SUBCASE("Verified by a parser") {
+    const MultiLiteralSearcher searcher{"GET ", "POST "};
+    const auto request = (LitP<'G', 'E', 'T'>{} | LitP<'P', 'O', 'S', 'T'>{}) & CharP<' '>{} &
+                         CharP<'/'>{} & *lower_case_character;
+
+    std::vector<std::string_view> requests;
+    searcher.search("x GET /a POST GET /bc", request,
+                    [&](size_t, size_t, std::string_view match) { requests.push_back(match); });
+    CHECK(requests == std::vector<std::string_view>{"GET /a", "GET /bc"});
+  }
+
+  SUBCASE("Parses each offset once") {
+    // "b" and "bcd" start at the same offset, but "abc" is reported in between them.
+    const MultiLiteralSearcher searcher{"abc", "b", "bcd"};
+    CHECK(search(searcher, "abcd") == Matches{{1, 1}, {0, 0}, {2, 1}});
+
+    std::vector<size_t> parsed;
+    const auto parser = (*AnyP{}).action([&](std::string_view sv) { parsed.push_back(sv.size()); });
+    Matches matches;
+    searcher.search("abcd", parser, [&](size_t pattern, size_t offset, std::string_view) {
+      matches.emplace_back(pattern, offset);
+    });
+    CHECK(matches == Matches{{1, 1}, {0, 0}, {2, 1}});
+    CHECK(parsed == std::vector<size_t>{3, 4});
+  }
+
+  SUBCASE("Empty pattern") {
+    CHECK_THROWS_AS((MultiLiteralSearcher{"a", ""}), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Search") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  using Matches = std::vector<std::string_view>;
+  const auto octet = +digit;
+  const auto ipv4 = octet & dot & octet & dot & octet & dot & octet;
+
+  SUBCASE("find") {
+    CHECK(find("src=10.0.0.1 dst=192.168.1.20", ipv4) == std::string_view{"10.0.0.1"});
+    CHECK(find("version 1.2.3", ipv4) == std::nullopt);
+    CHECK(find("", ipv4) == std::nullopt);
+    CHECK(find("abc", CharP<'c'>{}) == std::string_view{"c"});
+    CHECK(find("abc", CharP<'d'>{}) == std::nullopt);
+
+    constexpr auto found = find("abc123def", octet);
+    static_assert(found.has_value() && *found == "123");
+  }
+
+  SUBCASE("find_all") {
+    CHECK(find_all("10.0.0.1 -> 192.168.1.20, 1.2.3", ipv4) == Matches{"10.0.0.1", "192.168.1.20"});
+    CHECK(find_all("a1b22c333", octet) == Matches{"1", "22", "333"});
+    CHECK(find_all("a-b-c", dash) == Matches{"-", "-"});
+    CHECK(find_all("abc", digit).empty());
+  }
+
+  SUBCASE("Matches don't overlap") {
+    CHECK(find_all("aaaaa", CharP<'a'>{} & CharP<'a'>{}) == Matches{"aa", "aa"});
+  }
+
+  SUBCASE("Nullable parsers match everywhere") {
+    CHECK(find("a1", *digit) == std::string_view{""});
+    CHECK(find_all("a1", *digit) == Matches{"", "1", ""});
+  }
+
+  SUBCASE("Opaque parsers") {
+    const Erased erased{octet};
+    CHECK(find_all("a1b22", ParserRef{erased}) == Matches{"1", "22"});
+  }
+
+  SUBCASE("Required literals") {
+    constexpr auto scheme = +lower_case_character;
+    constexpr auto url = scheme & LitP<':', '/', '/'>{} & +(alphanumeric | dot);
+    static_assert(decltype(url)::required.view() == "://");
+    static_assert(decltype(url)::required.min_offset == 1);
+    static_assert(decltype(url)::required.max_offset == unbounded);
+    static_assert(decltype(url)::min_width == 5);
+    static_assert(decltype(url)::max_width == unbounded);
+
+    constexpr auto level = CharP<'['>{} & 2 * upper_case_character & CharP<']'>{};
+    constexpr auto error = ~level & LitP<'E', 'R', 'R', 'O', 'R', ' '>{} & digit;
+    static_assert(decltype(error)::required.view() == "ERROR ");
+    static_assert(decltype(error)::required.min_offset == 0);
+    static_assert(decltype(error)::required.max_offset == unbounded);
+    static_assert(decltype(~digit & LitP<'a', 'b'>{})::required.max_offset == 1);
+    static_assert(decltype(digit | LitP<'a', 'b'>{})::required.size == 0);
+
+    CHECK(find_all("see http://a.b or ftp://c, not ://d or http:/e", url) ==
+          Matches{"http://a.b", "ftp://c"});
+    CHECK(find_all("[XY]ERROR 1 ERROR 2 ERROR x", error) == Matches{"[XY]ERROR 1", "ERROR 2"});
+    CHECK(find("ERROR", error) == std::nullopt);
+
+    // Compare against trying the parser at every offset.
+    std::string text;
+    uint32_t seed = 1;
+    for (int i = 0; i < 5000; ++i) {
+      seed = seed * 1103515245U + 12345U;
+      text += "ab:/ 1.x"[(seed >> 16U) % 8];
+    }
+    Matches expected;
+    for (size_t i = 0; i < text.size();) {
+      const auto rest = std::string_view{text}.substr(i);
+      if (const auto result = url.parse(rest); result) {
+        expected.push_back(rest.substr(0, rest.size() - result.value.size()));
+        i += expected.back().size();
+      } else {
+        ++i;
+      }
+    }
+    CHECK(!expected.empty());
+    CHECK(find_all(text, url) == expected);
+  }
+
+  SUBCASE("Long inputs") {
+    std::string text(1000, ' ');
+    text.replace(700, 7, "1.2.3.4");
+    text.replace(990, 8, "10.0.0.1");
+    CHECK(find_all(text, ipv4) == Matches{"1.2.3.4", "10.0.0.1"});
+    CHECK(find(std::string(1000, 'x') + "y", CharP<'y'>{}) == std::string_view{"y"});
+  }
+}
+
+TEST_CASE("StreamParser") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  using Records = std::vector<std::string>;
+  const auto record = LitP<'i', 'd', '='>{} & +digit & CharP<','>{} & +letter & newline;
+  const std::string text = "id=1,a\nid=22,bc\nid=333,def\nid=4444,ghij\n";
+  const Records expected{"id=1,a\n", "id=22,bc\n", "id=333,def\n", "id=4444,ghij\n"};
+
+  SUBCASE("Single chunk") {
+    Records records;
+    StreamParser stream{record, [&](std::string_view r) { records.emplace_back(r); }};
+    CHECK(stream.feed(text) == StreamStatus::need_more_input);
+    CHECK(stream.buffered() == 0);
+    CHECK(stream.finish() == StreamStatus::done);
+    CHECK(records == expected);
+    CHECK(stream.consumed() == text.size());
+  }
+
+  SUBCASE("Every split") {
+    for (size_t size = 1; size <= text.size(); ++size) {
+      Records records;
+      StreamParser stream{record, [&](std::string_view r) { records.emplace_back(r); }};
+      for (size_t i = 0; i < text.size(); i += size) {
+        // The chunk is copied and destroyed right after feeding it, so nothing may refer to it.
+        CHECK(stream.feed(std::string{text.substr(i, size)}) == StreamStatus::need_more_input);
+        CHECK(stream.buffered() <= 15);
+      }
+      CHECK(stream.finish() == StreamStatus::done);
+      CHECK(records == expected);
+    }
+  }
+
+  SUBCASE("Record split across chunks") {
+    Records records;
+    StreamParser stream{record, [&](std::string_view r) { records.emplace_back(r); }};
+    // The buffer of the first chunk is overwritten by the second one.
+    std::string chunk = "id=12,a";
+    CHECK(stream.feed(chunk) == StreamStatus::need_more_input);
+    CHECK(records.empty());
+    chunk = "bc\nid=3,d\n";
+    CHECK(stream.feed(chunk) == StreamStatus::need_more_input);
+    CHECK(records == Records{"id=12,abc\n", "id=3,d\n"});
+    CHECK(stream.buffered() == 0);
+  }
+
+  SUBCASE("Record at the end of the stream") {
+    Records records;
+    const auto number = +digit & ~newline;
+    StreamParser stream{number, [&](std::string_view r) { records.emplace_back(r); }};
+    CHECK(stream.feed("12\n3") == StreamStatus::need_more_input);
+    CHECK(stream.feed("4") == StreamStatus::need_more_input);
+    CHECK(records == Records{"12\n"});
+    CHECK(stream.finish() == StreamStatus::done);
+    CHECK(records == Records{"12\n", "34"});
+  }
+
+  SUBCASE("Long record") {
+    Records records;
+    StreamParser stream{record, [&](std::string_view r) { records.emplace_back(r); }};
+    const std::string digits(1000, '7');
+    CHECK(stream.feed("id=") == StreamStatus::need_more_input);
+    CHECK(stream.feed(digits) == StreamStatus::need_more_input);
+    CHECK(stream.feed(",x\nid=1,y\n") == StreamStatus::need_more_input);
+    CHECK(records == Records{"id=" + digits + ",x\n", "id=1,y\n"});
+  }
+
+  SUBCASE("Errors") {
+    Records records;
+    StreamParser stream{record, [&](std::string_view r) { records.emplace_back(r); }};
+    CHECK(stream.feed("id=1,a\nid") == StreamStatus::need_more_input);
+    CHECK(stream.feed("=x,a\n") == StreamStatus::error);
+    CHECK(stream.consumed() == 7);
+    CHECK(stream.feed("id=2,b\n") == StreamStatus::error);
+    CHECK(stream.finish() == StreamStatus::error);
+    CHECK(records == Records{"id=1,a\n"});
+
+    StreamParser cut{record, [](std::string_view) {}};
+    CHECK(cut.feed("id=1") == StreamStatus::need_more_input);
+    CHECK(cut.finish() == StreamStatus::error);
+
+    // A record shorter than the min_width of the record parser could still be completed.
+    StreamParser short_record{record, [](std::string_view) {}};
+    CHECK(short_record.feed("id=x") == StreamStatus::need_more_input);
+    CHECK(short_record.feed(",a\n") == StreamStatus::error);
+    CHECK(short_record.consumed() == 0);
+  }
+}
+
+TEST_CASE("MappedInput") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  const std::string path = "tiny_parse_mapped_input_test.txt";
+  const auto write = [&](const std::string& contents) {
+    std::ofstream{path, std::ios::binary} << contents;
+  };
+  const auto number = +digit & *(CharP<','>{} & +digit);
+
+  SUBCASE("parse_file") {
+    write("1,22,333");
+    std::vector<std::string_view> numbers;
+    const auto collect = [&](std::string_view n) { numbers.push_back(n); };
+    const auto list = (+digit).action(collect) & *(CharP<','>{} & (+digit).action(collect));
+    const auto file = parse_file(path, list);
+    CHECK(file);
+    CHECK(file.result == Result{"", true});
+    CHECK(file.input.view() == "1,22,333");
+    CHECK(numbers == std::vector<std::string_view>{"1", "22", "333"});
+    CHECK(numbers.front().data() == file.input.data());
+  }
+
+  SUBCASE("Views outlive moves") {
+    write("12,x");
+    auto file = parse_file(path, number, {false, false, true});
+    CHECK(file.result == Result{",x", true});
+    const MappedInput input = std::move(file.input);
+    CHECK(file.result.value == ",x");
+    CHECK(file.result.value.data() == input.data() + 2);
+  }
+
+  SUBCASE("Empty file") {
+    write("");
+    const MappedInput input{path};
+    CHECK(input.size() == 0);
+    CHECK((std::string_view{input} >> number) == Result{"", false});
+  }
+
+  std::remove(path.c_str());
+
+  SUBCASE("Missing file") {
+    CHECK_THROWS_AS(MappedInput{"tiny_parse_missing_file.txt"}, std::system_error);
+  }
+}
+
+TEST_CASE("ThreadPool") {
+  using namespace tiny_parse;
+
+  for (const size_t workers : {0, 1, 3}) {
+    ThreadPool pool{workers};
+    CHECK(pool.concurrency() == workers + 1);
+
+    std::vector<std::atomic<int>> runs(1000);
+    pool.parallel_for(runs.size(), [&](size_t i) { ++runs[i]; });
+    CHECK(std::all_of(runs.begin(), runs.end(), [](const auto& n) { return n == 1; }));
+
+    std::atomic<size_t> nested{0};
+    pool.parallel_for(8, [&](size_t) { pool.parallel_for(8, [&](size_t) { ++nested; }); });
+    CHECK(nested == 64);
+
+    CHECK_THROWS_AS(pool.parallel_for(10,
+                                      [](size_t i) {
+                                        if (i == 5) throw std::runtime_error{"task failed"};
+                                      }),
+                    std::runtime_error);
+  }
+}
+
+TEST_CASE("parallel_parse_records") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  struct Sink {
+    std::vector<std::string_view> records;
+    void operator()(std::string_view record) { records.push_back(record); }
+    void merge(Sink&& other) {
+      records.insert(records.end(), other.records.begin(), other.records.end());
+    }
+  };
+
+  const auto record = +digit & CharP<','>{} & +letter;
+  ThreadPool pool{3};
+
+  std::string buffer;
+  std::vector<std::string_view> expected;
+  for (int i = 0; i < 50000; ++i) buffer += std::to_string(i) + ",abc\n";
+  for (size_t i = 0; i < buffer.size(); i = buffer.find('\n', i) + 1) {
+    expected.push_back(std::string_view{buffer}.substr(i, buffer.find('\n', i) - i));
+  }
+
+  SUBCASE("Records in order") {
+    Sink sink;
+    const auto result = parallel_parse_records(buffer, '\n', record, sink, pool);
+    CHECK(result);
+    CHECK(result.records == 50000);
+    CHECK(sink.records == expected);
+  }
+
+  SUBCASE("Last delimiter is optional") {
+    Sink sink;
+    CHECK(parallel_parse_records("1,a\n2,b", '\n', record, sink, pool).records == 2);
+    CHECK(sink.records == std::vector<std::string_view>{"1,a", "2,b"});
+  }
+
+  SUBCASE("First error") {
+    buffer.replace(buffer.find("31337,abc"), 9, "31337;abc");
+    buffer.replace(buffer.find("41337,abc"), 9, "41337;abc");
+    Sink sink;
+    const auto result = parallel_parse_records(buffer, '\n', record, sink, pool);
+    CHECK(!result);
+    CHECK(result.records == 31337);
+    CHECK(result.error_offset == buffer.find("31337;"));
+    CHECK(sink.records.size() == 31337);
+    CHECK(sink.records.back() == "31336,abc");
+  }
+
+  SUBCASE("Empty buffer") {
+    Sink sink;
+    CHECK(parallel_parse_records("", '\n', record, sink, pool).records == 0);
+  }
+
+  SUBCASE("Quoted delimiters") {
+    const auto quote = CharP<'"'>{};
+    const auto quoted = quote & *(LitP<'"', '"'>{} | (AnyP{} - quote)) & quote;
+    const auto plain = *(AnyP{} - quote - CharP<','>{} - newline);
+    const auto field = quoted | plain;
+    const auto row = field & *(CharP<','>{} & field);
+
+    std::string csv;
+    uint32_t seed = 7;
+    const auto random = [&](uint32_t n) {
+      seed = seed * 1103515245U + 12345U;
+      return (seed >> 16U) % n;
+    };
+    for (int i = 0; i < 20000; ++i) {
+      csv += std::to_string(i) + ",\"";
+      const std::array<std::string_view, 6> pieces{"a", "b", "\n", ",", "\"\"", " "};
+      for (auto n = random(40); n > 0; --n) csv += pieces[random(6)];
+      csv += random(2) == 0 ? "\",x\n" : "\"\n";
+    }
+
+    std::vector<std::string_view> rows;
+    bool in_quotes = false;
+    for (size_t i = 0, begin = 0; i < csv.size(); ++i) {
+      if (csv[i] == '"') in_quotes = !in_quotes;
+      if (csv[i] == '\n' && !in_quotes) {
+        rows.push_back(std::string_view{csv}.substr(begin, i - begin));
+        begin = i + 1;
+      }
+    }
+    CHECK(rows.size() == 20000);
+
+    Sink sink;
+    const auto result = parallel_parse_quoted_records(csv, '\n', '"', row, sink, pool);
+    CHECK(result);
+    CHECK(sink.records == rows);
+
+    // Splitting at every newline cuts the quoted fields apart.
+    Sink naive;
+    CHECK(!parallel_parse_records(csv, '\n', row, naive, pool));
+
+    Sink small;
+    CHECK(parallel_parse_quoted_records("\"a\nb\",1\nc", '\n', '"', row, small, pool).records == 2);
+    CHECK(small.records == std::vector<std::string_view>{"\"a\nb\",1", "c"});
+  }
+}
+
+TEST_CASE("ParMany") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  ThreadPool pool{3};
+  const auto record = +digit & CharP<','>{} & +letter;
+
+  std::string text;
+  for (int i = 0; i < 50000; ++i) text += std::to_string(i) + ",abc\n";
+
+  SUBCASE("Like Many") {
+    std::vector<std::string_view> elements;
+    std::vector<std::string_view> expected;
+    const auto collect = [&](std::string_view e) { elements.push_back(e); };
+    const auto parallel = par_many(record, newline, collect, pool);
+    const auto sequential = *(record & newline).action([&](std::string_view e) {
+      expected.push_back(e.substr(0, e.size() - 1));
+    });
+
+    for (const std::string_view input : {std::string_view{text}, std::string_view{"1,a\n2,b"},
+                                         std::string_view{"1,a\n2;b\n3,c\n"},
+                                         std::string_view{""}}) {
+      elements.clear();
+      expected.clear();
+      CHECK(parallel.parse(input) == sequential.parse(input));
+      CHECK(elements == expected);
+    }
+    CHECK(elements.empty());
+  }
+
+  SUBCASE("Stops at the first failing element") {
+    text.replace(text.find("31337,abc"), 9, "31337;abc");
+    text.replace(text.find("41337,abc"), 9, "41337;abc");
+    size_t elements = 0;
+    const auto parser = par_many(record, newline, [&](std::string_view) { ++elements; }, pool);
+    const auto result = parser.parse(text);
+    CHECK(result.success);
+    CHECK(result.value.data() == text.data() + text.find("31337;"));
+    CHECK(elements == 31337);
+  }
+
+  SUBCASE("Element values") {
+    const Symbols<int> numbers{{"one", 1}, {"two", 2}, {"three", 3}};
+    std::vector<int> values;
+    const auto list = par_many(numbers, CharP<','>{}, [&](int v) { values.push_back(v); }, pool) &
+                      CharP<'.'>{};
+    CHECK(list.parse("two,three,one,.") == Result{"", true});
+    CHECK(values == std::vector<int>{2, 3, 1});
+  }
+
+  SUBCASE("Without callback") {
+    CHECK(par_many(record, newline).parse("1,a\n2,b\nx") == Result{"x", true});
+  }
+}
+
+TEST_CASE("Symbols") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  enum class Method { get, gets, post, put, patch };
+  const Symbols<Method> methods{{"GET", Method::get},
+                                {"GETS", Method::gets},
+                                {"POST", Method::post},
+                                {"PUT", Method::put},
+                                {"PATCH", Method::patch}};
+  CHECK(methods.min_length() == 3);
+
+  SUBCASE("Longest match") {
+    CHECK(methods.parse("GET /") == Result{" /", true});
+    CHECK(methods.parse("GETS /") == Result{" /", true});
+    CHECK(methods.parse("GETX") == Result{"X", true});
+    CHECK(methods.parse("GE") == Result{"GE", false});
+    CHECK(methods.parse("PA") == Result{"PA", false});
+    CHECK(methods.parse("DELETE") == Result{"DELETE", false});
+    CHECK(methods.parse("") == Result{"", false});
+  }
+
+  SUBCASE("Value") {
+    Method method{};
+    CHECK(methods.parse("PATCH", method) == Result{"", true});
+    CHECK(method == Method::patch);
+    CHECK(methods.parse("GETS", method) == Result{"", true});
+    CHECK(method == Method::gets);
+  }
+
+  SUBCASE("Action") {
+    std::vector<Method> parsed;
+    const auto method = methods.action([&](Method m) { parsed.push_back(m); });
+    const auto line = method & *(CharP<' '>{} & method);
+    CHECK(line.parse("PUT GET POST") == Result{"", true});
+    CHECK(parsed == std::vector<Method>{Method::put, Method::get, Method::post});
+  }
+
+  SUBCASE("Many keywords") {
+    std::vector<std::pair<std::string, int>> words;
+    for (int i = 0; i < 500; ++i) words.emplace_back("key" + std::to_string(i), i);
+    const Symbols<int> keys{words.begin(), words.end()};
+    int value = -1;
+    CHECK(keys.parse("key499", value) == Result{"", true});
+    CHECK(value == 499);
+    CHECK(keys.parse("key42!", value) == Result{"!", true});
+    CHECK(value == 42);
+    CHECK(keys.parse("kex1", value) == Result{"kex1", false});
+  }
+
+  SUBCASE("Invalid keywords") {
+    CHECK_THROWS_AS((Symbols<int>{{"", 1}}), std::invalid_argument);
+    CHECK_THROWS_AS((Symbols<int>{{"a", 1}, {"a", 2}}), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Erased") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  const Erased erased{CharP<'a'>{} & CharP<'b'>{}};
+  const Parser& parser = erased;
+  CHECK(parser.min_length() == 2);
+  CHECK(parser.parse("abc") == Result{"c", true});
+  CHECK(parser.parse("ac") == Result{"ac", false});
+}
+
+TEST_CASE("ParserRef") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  const Erased erased{CharP<'a'>{}};
+  const auto parser = ParserRef{erased} & CharP<'b'>{};
+  CHECK(parser.min_length() == 1);
+  CHECK(parser.parse("abc") == Result{"c", true});
+  CHECK(parser.parse("bc") == Result{"bc", false});
+}
+
+TEST_CASE("Nullable repetitions") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  SUBCASE("Compile time") {
+    static_assert(decltype(~digit)::provably_nullable);
+    static_assert(decltype(*digit)::provably_nullable);
+    static_assert(decltype(~digit & ~letter)::provably_nullable);
+    static_assert(decltype(digit | ~letter)::provably_nullable);
+    const auto action = (~digit).action([](std::string_view) {});
+    static_assert(decltype(action)::provably_nullable);
+    static_assert(!decltype(~digit & letter)::provably_nullable);
+    static_assert(!decltype(+digit)::provably_nullable);
+    static_assert(!decltype(digit | letter)::provably_nullable);
+    // A ParserRef might be nullable, but isn't known to be.
+    static_assert(ParserRef::nullable);
+    static_assert(!ParserRef::provably_nullable);
+    static_assert(!decltype(ParserRef{std::declval<const Parser&>()} | digit)::provably_nullable);
+  }
+
+  SUBCASE("Run time") {
+    // Elements that consume nothing end the repetition, instead of matching forever.
+    const Erased erased{~CharP<'a'>{} & ~CharP<'b'>{}};
+    const ParserRef ref{erased};
+    CHECK((*ref).parse("abaabx") == Result{"x", true});
+    CHECK((*ref).parse("x") == Result{"x", true});
+    CHECK((+ref).parse("x") == Result{"x", true});
+    CHECK((ref > 1).parse("ab") == Result{"", true});
+    CHECK((ref > 1).parse("x") == Result{"x", true});
+    CHECK((ref > 1).parse("abab") == Result{"", true});
+    CHECK(fold(ref, 0, [](int count, std::string_view) { return count + 1; }).parse("aax") ==
+          Result{"x", true});
+
+    int count = 0;
+    CHECK(fold(ref, 0, [](int n, std::string_view) { return n + 1; }).parse("aax", count) ==
+          Result{"x", true});
+    CHECK(count == 3);
+  }
+}
+
+TEST_CASE("Lookahead") {
+  using namespace tiny_parse;
+  using namespace tiny_parse::built_in;
+
+  SUBCASE("Compile time") {
+    static_assert(decltype(!digit)::nullable);
+    static_assert(decltype(!digit)::provably_nullable);
+    static_assert(decltype(followed_by(digit))::max_width == 0);
+    static_assert(decltype(LitP<'i', 'f'>{} & !alphanumeric)::min_width == 2);
+    static_assert(std::is_same_v<attribute_of_t<decltype(!digit)>, Unused>);
+    static_assert((!digit).parse("a") == Result{"a", true});
+    static_assert(followed_by(LitP<'a', 'b'>{}).parse("abc") == Result{"abc", true});
+  }
+
+  SUBCASE("Not") {
+    const auto keyword = LitP<'i', 'f'>{} & !alphanumeric;
+    CHECK(keyword.parse("if x") == Result{" x", true});
+    CHECK(keyword.parse("if") == Result{"", true});
+    CHECK(keyword.parse("iffy") == Result{"iffy", false});
+    CHECK(keyword.parse("if2") == Result{"if2", false});
+
+    CHECK((!digit).parse("1") == Result{"1", false});
+    CHECK((!digit).parse("a") == Result{"a", true});
+    CHECK(not_followed_by(LitP<'a', 'b'>{}).parse("ab") == Result{"ab", false});
+    CHECK(not_followed_by(LitP<'a', 'b'>{}).parse("ac") == Result{"ac", true});
+    CHECK(not_followed_by(LitP<'a', 'b'>{}).parse("b") == Result{"b", true});
+  }
+
+  SUBCASE("And") {
+    CHECK(followed_by(digit).parse("1") == Result{"1", true});
+    CHECK(followed_by(digit).parse("a") == Result{"a", false});
+    CHECK(followed_by(LitP<'a', 'b'>{}).parse("ac") == Result{"ac", false});
+    CHECK(followed_by(LitP<'a', 'b'>{}).parse("b") == Result{"b", false});
+
+    const auto number_then_unit = +digit & followed_by(LitP<'k', 'm'>{} | LitP<'m'>{});
+    CHECK(number_then_unit.parse("12km") == Result{"km", true});
+    CHECK(number_then_unit.parse("12m") == Result{"m", true});
+    CHECK(number_then_unit.parse("12s") == Result{"12s", false});
+  }
+
+  SUBCASE("Nullable operand") {
+    // A nullable parser always matches, so it can't be ruled out from the next character.
+    CHECK((!~digit).parse("a") == Result{"a", false});
+    CHECK(followed_by(~digit).parse("a") == Result{"a", true});
+  }
+
+  SUBCASE("End of input") {
+    tiny_parse::detail::reached_end = false;
+    CHECK((!digit).parse("") == Result{"", true});
+    CHECK(tiny_parse::detail::reached_end);
+
+    tiny_parse::detail::reached_end = false;
+    CHECK(followed_by(digit).parse("") == Result{"", false});
+    CHECK(tiny_parse::detail::reached_end);
+
+    tiny_parse::detail::reached_end = false;
+    CHECK((!digit).parse("a") == Result{"a", true});
+    CHECK(!tiny_parse::detail::reached_end);
+  }
+}
+
 TEST_CASE("Result") {
   using namespace tiny_parse;
   using namespace tiny_parse::built_in;